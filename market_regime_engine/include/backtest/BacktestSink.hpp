@@ -0,0 +1,128 @@
+#pragma once
+#include "backtest/Metrics.hpp"
+#include "models/RegimeIndex.hpp"
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Receives a streamed backtest bar by bar instead of materialized series.
+// begin() sees the first price's date and the initial equity; on_bar(i, ...)
+// sees the values BacktestResult would hold at returns[i] and
+// equity_curve[i + 1].
+class BacktestSink {
+public:
+    virtual ~BacktestSink() = default;
+    virtual void begin(const std::string& /*date*/, double /*initial_equity*/) {}
+    virtual void on_bar(size_t index, const std::string& date, double ret, double equity) = 0;
+    virtual void end() {}
+};
+
+// Overall performance, matching Metrics on the full series exactly
+class MetricsSink : public BacktestSink {
+public:
+    void begin(const std::string&, double initial_equity) override {
+        equity_.add(initial_equity);
+    }
+
+    void on_bar(size_t, const std::string&, double ret, double equity) override {
+        returns_.add(ret);
+        equity_.add(equity);
+    }
+
+    const ReturnAccumulator& returns() const { return returns_; }
+    const EquityAccumulator& equity() const { return equity_; }
+
+    double total_return() const { return equity_.total_return(); }
+    double annual_return() const { return returns_.annual_return(); }
+    double sharpe() const { return returns_.sharpe(); }
+    double max_drawdown() const { return equity_.max_drawdown(); }
+
+private:
+    ReturnAccumulator returns_;
+    EquityAccumulator equity_;
+};
+
+// Return statistics per regime. Labels are aligned with the return index, as
+// in the in-memory regime breakdown; returns past the last label are ignored.
+class RegimeMetricsSink : public BacktestSink {
+public:
+    explicit RegimeMetricsSink(const RegimeIndex& index)
+        : index_(index), by_regime_(index.num_regimes()) {}
+
+    void begin(const std::string&, double) override { span_ = 0; }
+
+    void on_bar(size_t index, const std::string&, double ret, double) override {
+        const auto& spans = index_.spans();
+        while (span_ < spans.size() && index >= spans[span_].start + spans[span_].length) {
+            ++span_;
+        }
+        if (span_ < spans.size()) {
+            by_regime_[spans[span_].regime].add(ret);
+        }
+    }
+
+    const std::vector<ReturnAccumulator>& by_regime() const { return by_regime_; }
+
+private:
+    const RegimeIndex& index_;
+    std::vector<ReturnAccumulator> by_regime_;
+    size_t span_ = 0;
+};
+
+// Writes every `every`-th equity point, plus the first and last, as
+// Date,Equity CSV rows
+class SampledEquitySink : public BacktestSink {
+public:
+    SampledEquitySink(std::ostream& out, size_t every) : out_(out), every_(every > 0 ? every : 1) {}
+
+    void begin(const std::string& date, double initial_equity) override {
+        out_ << "Date,Equity\n" << date << "," << initial_equity << "\n";
+        pending_ = false;
+    }
+
+    void on_bar(size_t index, const std::string& date, double, double equity) override {
+        if ((index + 1) % every_ == 0) {
+            out_ << date << "," << equity << "\n";
+            pending_ = false;
+        } else {
+            last_date_ = date;
+            last_equity_ = equity;
+            pending_ = true;
+        }
+    }
+
+    void end() override {
+        if (pending_) {
+            out_ << last_date_ << "," << last_equity_ << "\n";
+        }
+        out_.flush();
+    }
+
+private:
+    std::ostream& out_;
+    size_t every_;
+    std::string last_date_;
+    double last_equity_ = 0.0;
+    bool pending_ = false;
+};
+
+// Forwards to several sinks so one pass can feed them all
+class MultiSink : public BacktestSink {
+public:
+    explicit MultiSink(std::vector<BacktestSink*> sinks) : sinks_(std::move(sinks)) {}
+
+    void begin(const std::string& date, double initial_equity) override {
+        for (auto* s : sinks_) s->begin(date, initial_equity);
+    }
+
+    void on_bar(size_t index, const std::string& date, double ret, double equity) override {
+        for (auto* s : sinks_) s->on_bar(index, date, ret, equity);
+    }
+
+    void end() override {
+        for (auto* s : sinks_) s->end();
+    }
+
+private:
+    std::vector<BacktestSink*> sinks_;
+};
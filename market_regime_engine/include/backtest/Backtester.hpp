@@ -1,6 +1,8 @@
 #pragma once
 #include "core/TimeSeries.hpp"
 #include "strategies/Strategy.hpp"
+#include "backtest/BacktestSink.hpp"
+#include <stdexcept>
 
 class Backtester {
 public:
@@ -35,4 +37,60 @@ public:
 
         return result;
     }
-};
\ No newline at end of file
+
+    // Incremental backtest: prices are pushed one at a time and each return
+    // and equity value goes straight to the sink. Keeps O(warmup) state, so
+    // a series of any length can be fed from a stream.
+    class Stream {
+    public:
+        Stream(Strategy& strategy, BacktestSink& sink, double initial_equity = 100.0)
+            : strategy_(strategy), sink_(sink), equity_(initial_equity) {
+            strategy_.reset();
+        }
+
+        void push(double price, const std::string& date) {
+            if (has_prev_) {
+                double price_return = (price - prev_price_) / prev_price_;
+                double strategy_return = prev_signal_ * price_return;
+                equity_ = equity_ * (1.0 + strategy_return);
+                sink_.on_bar(bars_++, date, strategy_return, equity_);
+            } else {
+                sink_.begin(date, equity_);
+            }
+            prev_price_ = price;
+            prev_signal_ = strategy_.on_price(price);
+            has_prev_ = true;
+        }
+
+        void push(double price) { push(price, no_date_); }
+
+        void finish() { sink_.end(); }
+
+    private:
+        Strategy& strategy_;
+        BacktestSink& sink_;
+        double equity_;
+        double prev_price_ = 0.0;
+        double prev_signal_ = 0.0;
+        bool has_prev_ = false;
+        size_t bars_ = 0;
+        std::string no_date_;
+    };
+
+    // Low-memory run: same numbers as run(), but nothing is materialized
+    static void run(const TimeSeries& prices, Strategy& strategy, BacktestSink& sink) {
+        if (prices.size() < strategy.warmup()) {
+            throw std::invalid_argument("Price series too short for strategy");
+        }
+
+        Stream stream(strategy, sink);
+        for (size_t i = 0; i < prices.size(); ++i) {
+            if (i < prices.dates.size()) {
+                stream.push(prices[i], prices.dates[i]);
+            } else {
+                stream.push(prices[i]);
+            }
+        }
+        stream.finish();
+    }
+};
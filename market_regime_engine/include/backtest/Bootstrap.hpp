@@ -0,0 +1,40 @@
+#pragma once
+#include "core/TimeSeries.hpp"
+#include "models/RegimeIndex.hpp"
+#include <cstdint>
+#include <vector>
+
+// Block bootstrap of strategy returns within each regime. Blocks never join
+// returns from separate regime episodes (RegimeIndex spans): an episode of at
+// least block_length returns is resampled as a circular block bootstrap of
+// its own, and a shorter one is drawn whole, weighted as if it had
+// block_length start points so every return has equal coverage.
+// block_length = 1 degenerates to an i.i.d. Monte Carlo resample.
+class Bootstrap {
+public:
+    struct Config {
+        size_t replicates = 10000;
+        size_t block_length = 20;
+        double confidence = 0.95;
+        uint64_t seed = 42;
+        size_t batch_size = 256;
+        size_t num_threads = 0;  // 0 = hardware concurrency
+    };
+
+    struct Interval {
+        double estimate = 0.0;
+        double lower = 0.0;
+        double upper = 0.0;
+    };
+
+    struct RegimeInterval {
+        size_t regime = 0;
+        size_t observations = 0;
+        Interval sharpe;
+        Interval annual_return;
+    };
+
+    static std::vector<RegimeInterval> regime_intervals(const TimeSeries& returns,
+                                                        const RegimeIndex& regimes,
+                                                        const Config& config);
+};
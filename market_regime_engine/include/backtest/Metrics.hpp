@@ -1,27 +1,14 @@
 #pragma once
 #include "core/TimeSeries.hpp"
 #include "features/Drawdown.hpp"
+#include <algorithm>
 #include <cmath>
 
 class Metrics {
 public:
-    static double sharpe(const TimeSeries& returns, double risk_free_rate = 0.0) {
-        if (returns.size() == 0) return 0.0;
-
-        double mean = 0.0;
-        for (double r : returns.values) {
-            mean += r;
-        }
-        mean /= returns.size();
-
-        double variance = 0.0;
-        for (double r : returns.values) {
-            double diff = r - mean;
-            variance += diff * diff;
-        }
-        variance /= (returns.size() - 1);
-        double std_dev = std::sqrt(variance);
+    static double sharpe(const TimeSeries& returns, double risk_free_rate = 0.0);
 
+    static double sharpe_from_moments(double mean, double std_dev, double risk_free_rate = 0.0) {
         if (std_dev < 1e-8) return 0.0;
 
         double annualized_mean = mean * 252 - risk_free_rate;
@@ -39,15 +26,83 @@ public:
         return (equity_curve[equity_curve.size() - 1] - equity_curve[0]) / equity_curve[0];
     }
 
-    static double annual_return(const TimeSeries& returns) {
-        if (returns.size() == 0) return 0.0;
-        
-        double mean_daily = 0.0;
-        for (double r : returns.values) {
-            mean_daily += r;
+    static double annual_return(const TimeSeries& returns);
+};
+
+// Single-pass return statistics (Welford). Metrics::sharpe and
+// Metrics::annual_return are defined in terms of it, so a streamed backtest
+// reproduces the in-memory numbers exactly.
+class ReturnAccumulator {
+public:
+    void add(double r) {
+        ++count_;
+        sum_ += r;
+        double delta = r - mean_;
+        mean_ += delta / count_;
+        m2_ += delta * (r - mean_);
+    }
+
+    size_t count() const { return count_; }
+    double mean() const { return count_ > 0 ? sum_ / count_ : 0.0; }
+    double variance() const { return count_ > 1 ? m2_ / (count_ - 1) : 0.0; }
+
+    double sharpe(double risk_free_rate = 0.0) const {
+        if (count_ < 2) return 0.0;
+        return Metrics::sharpe_from_moments(mean(), std::sqrt(variance()), risk_free_rate);
+    }
+
+    double annual_return() const { return mean() * 252; }
+
+private:
+    size_t count_ = 0;
+    double sum_ = 0.0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+};
+
+// Streaming counterpart of Metrics::total_return / Drawdown::max_drawdown
+class EquityAccumulator {
+public:
+    void add(double equity) {
+        if (count_ == 0) {
+            first_ = equity;
+            peak_ = equity;
+        } else {
+            if (equity > peak_) {
+                peak_ = equity;
+            }
+            double dd = (equity - peak_) / peak_;
+            max_dd_ = std::min(max_dd_, dd);
         }
-        mean_daily /= returns.size();
-        
-        return mean_daily * 252;
+        last_ = equity;
+        ++count_;
+    }
+
+    size_t count() const { return count_; }
+    double last() const { return last_; }
+    double max_drawdown() const { return max_dd_; }
+    double total_return() const { return count_ < 2 ? 0.0 : (last_ - first_) / first_; }
+
+private:
+    size_t count_ = 0;
+    double first_ = 0.0;
+    double last_ = 0.0;
+    double peak_ = 0.0;
+    double max_dd_ = 0.0;
+};
+
+inline double Metrics::sharpe(const TimeSeries& returns, double risk_free_rate) {
+    ReturnAccumulator acc;
+    for (double r : returns.values) {
+        acc.add(r);
+    }
+    return acc.sharpe(risk_free_rate);
+}
+
+inline double Metrics::annual_return(const TimeSeries& returns) {
+    ReturnAccumulator acc;
+    for (double r : returns.values) {
+        acc.add(r);
     }
-};
\ No newline at end of file
+    return acc.annual_return();
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+
+// Counter-based random stream: every draw is a pure function of
+// (seed, stream, counter), so independent streams can be consumed from any
+// thread in any order and still reproduce the same sequence.
+class CounterRng {
+public:
+    CounterRng(uint64_t seed, uint64_t stream, uint64_t counter = 0)
+        : key_(mix(seed ^ mix(stream + 0x9E3779B97F4A7C15ULL))), counter_(counter) {}
+
+    static uint64_t mix(uint64_t z) {
+        z += 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t at(uint64_t counter) const { return mix(key_ ^ mix(counter)); }
+
+    uint64_t next() { return at(counter_++); }
+
+    // Uniform integer in [0, n) for n < 2^32 using a multiply-shift range reduction
+    uint32_t uniform_index(uint32_t n) {
+        return static_cast<uint32_t>(((next() >> 32) * n) >> 32);
+    }
+
+    // Uniform double in [0, 1)
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    uint64_t counter() const { return counter_; }
+
+private:
+    uint64_t key_;
+    uint64_t counter_;
+};
@@ -0,0 +1,39 @@
+#pragma once
+#include "core/Matrix.hpp"
+
+// Sequential, rewindable supplier of feature rows in blocks. Lets models make
+// several passes over data that need not fit in memory at once.
+template <typename T>
+class BasicFeatureSource {
+public:
+    virtual ~BasicFeatureSource() = default;
+    virtual size_t cols() const = 0;
+    virtual void rewind() = 0;
+    // Returns false once the source is exhausted. The view stays valid until
+    // the next call.
+    virtual bool next_block(BasicMatrixView<T>& block) = 0;
+};
+
+// Presents an in-memory matrix as a single block
+template <typename T>
+class BasicMatrixSource : public BasicFeatureSource<T> {
+public:
+    explicit BasicMatrixSource(const BasicMatrix<T>& X) : X_(X) {}
+
+    size_t cols() const override { return X_.cols; }
+    void rewind() override { done_ = false; }
+
+    bool next_block(BasicMatrixView<T>& block) override {
+        if (done_ || X_.rows == 0) return false;
+        block = X_.view();
+        done_ = true;
+        return true;
+    }
+
+private:
+    const BasicMatrix<T>& X_;
+    bool done_ = false;
+};
+
+using FeatureSource = BasicFeatureSource<double>;
+using MatrixSource = BasicMatrixSource<double>;
@@ -2,29 +2,54 @@
 #include <vector>
 #include <stdexcept>
 
-class Matrix {
+// Non-owning view over a contiguous row-major block of rows
+template <typename T>
+struct BasicMatrixView {
+    const T* data = nullptr;
+    size_t rows = 0;
+    size_t cols = 0;
+
+    const T* row(size_t i) const { return data + i * cols; }
+};
+
+template <typename T>
+class BasicMatrix {
 public:
     size_t rows, cols;
-    std::vector<double> data;
+    std::vector<T> data;
+
+    BasicMatrix(size_t r, size_t c) : rows(r), cols(c), data(r * c, T(0)) {}
 
-    Matrix(size_t r, size_t c) : rows(r), cols(c), data(r * c, 0.0) {}
+    // Element-wise conversion, e.g. MatrixF(X) to halve a double matrix's footprint
+    template <typename U>
+    explicit BasicMatrix(const BasicMatrix<U>& other)
+        : rows(other.rows), cols(other.cols), data(other.data.begin(), other.data.end()) {}
 
-    double& operator()(size_t i, size_t j) {
+    T& operator()(size_t i, size_t j) {
         if (i >= rows || j >= cols) throw std::out_of_range("Matrix index out of bounds");
         return data[i * cols + j];
     }
 
-    double operator()(size_t i, size_t j) const {
+    T operator()(size_t i, size_t j) const {
         if (i >= rows || j >= cols) throw std::out_of_range("Matrix index out of bounds");
         return data[i * cols + j];
     }
 
-    std::vector<double> get_row(size_t i) const {
+    std::vector<T> get_row(size_t i) const {
         if (i >= rows) throw std::out_of_range("Row index out of bounds");
-        std::vector<double> row(cols);
+        std::vector<T> row(cols);
         for (size_t j = 0; j < cols; ++j) {
             row[j] = data[i * cols + j];
         }
         return row;
     }
-};
\ No newline at end of file
+
+    BasicMatrixView<T> view() const { return BasicMatrixView<T>{data.data(), rows, cols}; }
+};
+
+using Matrix = BasicMatrix<double>;
+using MatrixView = BasicMatrixView<double>;
+
+// Single-precision feature storage: half the memory and bandwidth per row
+using MatrixF = BasicMatrix<float>;
+using MatrixViewF = BasicMatrixView<float>;
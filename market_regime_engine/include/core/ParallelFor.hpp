@@ -0,0 +1,32 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Runs task(i) for i in [0, count) on up to num_threads threads (0 = hardware
+// concurrency). Indices are handed out from a shared counter, so uneven tasks
+// balance; the calling thread works too.
+template <typename Task>
+void parallel_for(size_t count, size_t num_threads, Task&& task) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = std::min(num_threads, count);
+
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            task(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < num_threads; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& th : threads) {
+        th.join();
+    }
+}
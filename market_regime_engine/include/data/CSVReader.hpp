@@ -0,0 +1,42 @@
+#pragma once
+#include "core/TimeSeries.hpp"
+#include <fstream>
+#include <string>
+#include <vector>
+
+class CSVReader {
+public:
+    // Rows are returned in ascending time; newest-first files are reversed
+    static TimeSeries read_price_series(const std::string& path, 
+                                       const std::string& price_col = "Close");
+
+    // Restricts every series to the dates present in all of them, keeping
+    // each series' order
+    static void align_on_dates(std::vector<TimeSeries>& series);
+};
+
+// Reads a price CSV in fixed-size blocks of rows for out-of-core processing.
+// Like CSVReader, yields rows in ascending time: newest-first files are
+// read from the end backwards.
+class CSVChunkReader {
+public:
+    CSVChunkReader(const std::string& path, const std::string& price_col = "Close");
+
+    // Replaces chunk with up to max_rows rows; returns the number read (0 at EOF)
+    size_t read(TimeSeries& chunk, size_t max_rows);
+    void rewind();
+
+private:
+    std::string path_;
+    std::ifstream file_;
+    std::streampos data_start_;
+    std::streampos data_end_;
+    int price_idx_ = -1;
+    int date_idx_ = -1;
+
+    bool reverse_ = false;
+    std::streampos read_pos_;
+    std::string pending_;
+
+    bool next_line(std::string& line);
+};
@@ -0,0 +1,107 @@
+#pragma once
+#include "core/TimeSeries.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct Trade {
+    int64_t timestamp_ms = 0;
+    double price = 0.0;
+    double size = 0.0;
+};
+
+struct Bar {
+    int64_t start_ms = 0;
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+    size_t trades = 0;
+};
+
+// Sequential reader for one trade file with a header naming timestamp, price
+// and size columns. Timestamps are epoch milliseconds or ISO-8601 UTC
+// ("2024-03-01T14:30:00.250"), and must be non-decreasing.
+class TradeReader {
+public:
+    explicit TradeReader(const std::string& path);
+
+    bool next(Trade& trade);
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    std::ifstream file_;
+    std::vector<char> buffer_;
+    std::string line_;
+    int ts_idx_ = -1;
+    int price_idx_ = -1;
+    int size_idx_ = -1;
+    int64_t last_ts_ = INT64_MIN;
+    size_t line_no_ = 1;
+};
+
+// Merges several time-ordered trade files and rolls them into OHLCV bars in a
+// single pass. Only one pending trade per source and the open bar are
+// resident, so memory is independent of file size.
+class TickAggregator {
+public:
+    struct Bars {
+        TimeSeries open;
+        TimeSeries high;
+        TimeSeries low;
+        TimeSeries close;
+        TimeSeries volume;
+        size_t trades = 0;
+    };
+
+    // "30s", "1m", "5m", "1h", "1d" -> milliseconds
+    static int64_t parse_interval(const std::string& spec);
+
+    // Emits completed bars in ascending time; returns the number of trades merged
+    static size_t merge(const std::vector<std::string>& paths, int64_t interval_ms,
+                        const std::function<void(const Bar&)>& on_bar);
+
+    // Collects every bar as TimeSeries columns; memory grows with the bar
+    // count. To write bars to disk in bounded memory, pass merge() a
+    // BarCsvWriter instead.
+    static Bars aggregate(const std::vector<std::string>& paths, int64_t interval_ms);
+
+    // Writes Date,Open,High,Low,Close,Volume readable by CSVReader
+    static void write_csv(const Bars& bars, const std::string& path);
+
+    // "YYYY-MM-DD" for daily (or coarser) bars, "YYYY-MM-DD HH:MM[:SS]" otherwise
+    static std::string format_timestamp(int64_t ms, int64_t interval_ms);
+};
+
+// Appends bars to a CSV file (the write_csv format) as merge() completes them
+class BarCsvWriter {
+public:
+    BarCsvWriter(const std::string& path, int64_t interval_ms);
+    ~BarCsvWriter();
+
+    BarCsvWriter(const BarCsvWriter&) = delete;
+    BarCsvWriter& operator=(const BarCsvWriter&) = delete;
+
+    void write(const Bar& bar);
+    void write(const std::string& date, double open, double high, double low, double close,
+               double volume);
+
+    // Flushes and closes the file; throws if any write failed
+    void close();
+
+    // Closes and deletes a partly written file
+    void discard();
+
+    size_t bars() const { return bars_; }
+
+private:
+    std::string path_;
+    int64_t interval_ms_;
+    std::FILE* out_ = nullptr;
+    size_t bars_ = 0;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include "core/Matrix.hpp"
+#include "core/TimeSeries.hpp"
+#include <vector>
+
+// Rolling covariance across N assets maintained from running sums: each bar
+// adds the incoming return vector's outer product and removes the outgoing
+// one, O(N^2) per bar instead of O(W N^2). Only the upper triangle is stored
+// and updated. The sums are rebuilt exactly from the window every
+// refresh_interval bars to bound floating-point drift.
+class RollingCovariance {
+public:
+    RollingCovariance(size_t num_assets, size_t window, size_t refresh_interval = 0);
+
+    // Adds one bar of num_assets returns; true once the window is full
+    bool push(const double* returns);
+
+    bool ready() const { return filled_ == window_; }
+    size_t num_assets() const { return n_; }
+    size_t window() const { return window_; }
+
+    double covariance(size_t i, size_t j) const;
+    Matrix correlation() const;
+
+    // Mean of the off-diagonal correlations
+    double average_correlation();
+
+    // Largest eigenvalue of the correlation matrix divided by its trace, by
+    // power iteration warm-started from the previous bar's eigenvector
+    double top_eigenvalue_share(size_t max_iters = 50, double tolerance = 1e-6);
+
+private:
+    size_t n_;
+    size_t window_;
+    size_t refresh_interval_;
+    size_t head_ = 0;
+    size_t filled_ = 0;
+    size_t since_refresh_ = 0;
+
+    std::vector<double> buffer_;   // window_ x n_ ring of returns
+    std::vector<double> sums_;     // n_
+    std::vector<double> cross_;    // n_ x n_, upper triangle used
+    std::vector<double> inv_sd_;   // scratch
+    std::vector<double> eigvec_;   // warm start for power iteration
+    std::vector<double> scratch_;
+    std::vector<double> scaled_;
+
+    void rebuild();
+    void update_inverse_sd();
+};
+
+class CrossAsset {
+public:
+    // Regime features from aligned per-asset return series: one row per bar
+    // once `window` returns are available, columns (average pairwise
+    // correlation, top eigenvalue share). Row i covers returns [i, i+window).
+    static Matrix regime_features(const std::vector<TimeSeries>& returns, size_t window);
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include "core/TimeSeries.hpp"
 #include <algorithm>
+#include <vector>
 
 class Drawdown {
 public:
@@ -41,4 +42,33 @@ public:
         }
         return max_dd;
     }
-};
\ No newline at end of file
+};
+
+// Incremental form of Drawdown::rolling_drawdown for chunked processing
+class RollingDrawdown {
+public:
+    explicit RollingDrawdown(size_t window) : window_(window), buffer_(window) {
+        if (window == 0) throw std::invalid_argument("Window must be positive");
+    }
+
+    // Returns true and writes the drawdown once the window is full
+    bool push(double price, double& dd) {
+        buffer_[head_] = price;
+        head_ = (head_ + 1) % window_;
+        if (filled_ < window_) ++filled_;
+        if (filled_ < window_) return false;
+
+        double max_price = buffer_[head_];
+        for (size_t k = 1; k < window_; ++k) {
+            max_price = std::max(max_price, buffer_[(head_ + k) % window_]);
+        }
+        dd = (price - max_price) / max_price;
+        return true;
+    }
+
+private:
+    size_t window_;
+    std::vector<double> buffer_;
+    size_t head_ = 0;
+    size_t filled_ = 0;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include "core/Matrix.hpp"
+#include "core/TimeSeries.hpp"
+#include "features/Returns.hpp"
+#include "features/Volatility.hpp"
+#include "features/Drawdown.hpp"
+#include "features/Correlation.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// The K-Means feature matrix, built the same way by the in-memory run, the
+// daemon and the tests. Row i pairs the first asset's i-th rolling volatility
+// with its i-th rolling drawdown; with more than one date-aligned asset it
+// adds the cross-asset average correlation and top eigenvalue share. T is the
+// storage type; the rolling windows themselves run in double.
+class RegimeFeatures {
+public:
+    // dates, if given, receives the volatility date of each row
+    template <typename T>
+    static BasicMatrix<T> build(const std::vector<TimeSeries>& assets, size_t window = 20,
+                                std::vector<std::string>* dates = nullptr) {
+        if (assets.empty()) throw std::invalid_argument("Need at least one asset");
+
+        const TimeSeries& prices = assets.front();
+        TimeSeries returns = Returns::log_returns(prices);
+        TimeSeries vol = Volatility::rolling_vol(returns, window);
+        TimeSeries dd = Drawdown::rolling_drawdown(prices, window);
+
+        Matrix cross(0, 0);
+        if (assets.size() > 1) {
+            std::vector<TimeSeries> asset_returns;
+            for (const auto& a : assets) {
+                asset_returns.push_back(Returns::log_returns(a));
+            }
+            cross = CrossAsset::regime_features(asset_returns, window);
+        }
+
+        size_t rows = std::min(vol.size(), dd.size());
+        if (cross.rows > 0) {
+            rows = std::min(rows, cross.rows);
+        }
+
+        BasicMatrix<T> X(rows, 2 + cross.cols);
+        for (size_t i = 0; i < rows; ++i) {
+            X(i, 0) = static_cast<T>(vol[i]);
+            X(i, 1) = static_cast<T>(dd[i]);
+            for (size_t j = 0; j < cross.cols; ++j) {
+                X(i, 2 + j) = static_cast<T>(cross(i, j));  // avg correlation, top eigenvalue share
+            }
+        }
+
+        if (dates) {
+            dates->assign(vol.dates.begin(), vol.dates.begin() + std::min(rows, vol.dates.size()));
+        }
+        return X;
+    }
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include "core/TimeSeries.hpp"
 #include <cmath>
+#include <vector>
 
 class Volatility {
 public:
@@ -32,4 +33,44 @@ public:
         }
         return vol;
     }
-};
\ No newline at end of file
+};
+
+// Incremental form of Volatility::rolling_vol for chunked processing. The
+// window is kept in a ring buffer and reduced oldest-to-newest, so values
+// match the in-memory computation exactly across chunk boundaries.
+class RollingVolatility {
+public:
+    explicit RollingVolatility(size_t window) : window_(window), buffer_(window) {
+        if (window < 2) throw std::invalid_argument("Window must be at least 2");
+    }
+
+    // Returns true and writes the volatility once the window is full
+    bool push(double ret, double& vol) {
+        buffer_[head_] = ret;
+        head_ = (head_ + 1) % window_;
+        if (filled_ < window_) ++filled_;
+        if (filled_ < window_) return false;
+
+        double mean = 0.0;
+        for (size_t k = 0; k < window_; ++k) {
+            mean += buffer_[(head_ + k) % window_];
+        }
+        mean /= window_;
+
+        double variance = 0.0;
+        for (size_t k = 0; k < window_; ++k) {
+            double diff = buffer_[(head_ + k) % window_] - mean;
+            variance += diff * diff;
+        }
+        variance /= (window_ - 1);
+
+        vol = std::sqrt(variance * 252);
+        return true;
+    }
+
+private:
+    size_t window_;
+    std::vector<double> buffer_;
+    size_t head_ = 0;
+    size_t filled_ = 0;
+};
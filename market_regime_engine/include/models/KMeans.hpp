@@ -1,27 +1,57 @@
 #pragma once
 #include "core/Matrix.hpp"
+#include "core/FeatureSource.hpp"
+#include <random>
 #include <vector>
 
 class KMeans {
 public:
-    KMeans(size_t k, size_t max_iters = 100, double tolerance = 1e-4)
-        : k_(k), max_iters_(max_iters), tolerance_(tolerance) {}
+    KMeans(size_t k, size_t max_iters = 100, double tolerance = 1e-4,
+           unsigned int seed = std::random_device{}())
+        : k_(k), max_iters_(max_iters), tolerance_(tolerance), seed_(seed) {}
 
-    std::vector<int> fit_predict(const Matrix& X);
+    // Features may be stored as double (Matrix) or float (MatrixF). With float
+    // storage the assignment step runs in float: each row is compared with a
+    // float copy of the centroids and its squared distances are summed in
+    // float. Centroids, centroid sums, k-means++ weights and the inertia total
+    // stay in double.
+    template <typename T>
+    std::vector<int> fit_predict(const BasicMatrix<T>& X);
+
+    // Fits by streaming passes over the source; only one block is resident
+    // at a time. Produces the same centroids as fit_predict on the
+    // concatenated rows.
+    template <typename T>
+    void fit(BasicFeatureSource<T>& source);
+
+    // Labels each row of the block, adding its squared distances to inertia
+    template <typename T>
+    void predict(const BasicMatrixView<T>& block, int* labels, double& inertia) const;
     
+    void set_verbose(bool verbose) { verbose_ = verbose; }
+
     const Matrix& get_centroids() const { return centroids_; }
     double get_inertia() const { return inertia_; }
+    size_t get_iterations() const { return iterations_; }
 
 private:
     size_t k_;
     size_t max_iters_;
     double tolerance_;
+    unsigned int seed_;
     Matrix centroids_{0, 0};
     double inertia_ = 0.0;
+    size_t iterations_ = 0;
+    bool verbose_ = true;
 
-    void initialize_centroids(const Matrix& X);
-    std::vector<int> assign_clusters(const Matrix& X);
-    bool update_centroids(const Matrix& X, const std::vector<int>& labels);
-    double euclidean_distance(const std::vector<double>& a, 
-                             const std::vector<double>& b) const;
-};
\ No newline at end of file
+    template <typename T>
+    void initialize_centroids(BasicFeatureSource<T>& source);
+    template <typename T>
+    std::vector<T> transposed_centroids() const;
+    template <typename T>
+    size_t nearest_centroid(const T* row, const T* centroids_t, T* dist, double& min_sq_dist) const;
+    template <typename T>
+    double min_sq_distance(const T* row, size_t num_centroids) const;
+    template <typename T>
+    static double squared_distance(const T* a, const double* b, size_t n);
+};
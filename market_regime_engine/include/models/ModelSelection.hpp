@@ -0,0 +1,52 @@
+#pragma once
+#include "core/Matrix.hpp"
+#include <cstdint>
+#include <vector>
+
+// Chooses the number of K-Means regimes. Every (k, seed) fit runs in
+// parallel; each k is scored by inertia (with an elbow estimate), a
+// silhouette on a fixed row sample and the agreement of its labelings across
+// seeds. The sample's pairwise distances are computed once and shared by all
+// fits.
+class ModelSelection {
+public:
+    struct Config {
+        size_t min_k = 2;
+        size_t max_k = 8;
+        size_t seeds = 3;
+        size_t silhouette_sample = 1000;
+        double min_stability = 0.8;
+        size_t max_iters = 100;
+        double tolerance = 1e-4;
+        uint64_t seed = 42;
+        size_t num_threads = 0;  // 0 = hardware concurrency
+    };
+
+    struct Score {
+        size_t k = 0;
+        double inertia = 0.0;     // best over seeds
+        double silhouette = 0.0;  // of the best fit, on the sample
+        double stability = 1.0;   // mean adjusted Rand index across seeds
+        unsigned int seed = 0;    // KMeans seed of the best fit; refitting with it reproduces the fit
+    };
+
+    struct Result {
+        size_t best_k = 0;
+        unsigned int best_seed = 0;
+        size_t elbow_k = 0;
+        std::vector<Score> scores;
+    };
+
+    // X may be stored as double or float; every fit runs on X as stored, so
+    // a refit with the chosen k and seed on the same X reproduces it
+    template <typename T>
+    static Result select_k(const BasicMatrix<T>& X, const Config& config);
+
+    static double adjusted_rand_index(const std::vector<int>& a, const std::vector<int>& b, size_t k);
+
+    // Mean silhouette of m labelled points given their pairwise distances in
+    // condensed order (0,1), (0,2), ..., (0,m-1), (1,2), ...; singletons and
+    // points without a second cluster score 0
+    static double sampled_silhouette(const std::vector<double>& dist, const std::vector<int>& labels,
+                                     size_t k);
+};
@@ -0,0 +1,105 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+// Run-length encoding of a regime label sequence into (start, length, regime)
+// spans. Per-regime durations, span lists and transition counts are kept up to
+// date as labels are appended, so queries are O(1) and series aligned with the
+// labels can be sliced by regime without copying.
+class RegimeIndex {
+public:
+    struct Span {
+        size_t start;
+        size_t length;
+        int regime;
+    };
+
+    explicit RegimeIndex(size_t num_regimes)
+        : num_regimes_(num_regimes),
+          durations_(num_regimes, 0),
+          regime_spans_(num_regimes),
+          transitions_(num_regimes * num_regimes, 0) {}
+
+    RegimeIndex(const std::vector<int>& labels, size_t num_regimes) : RegimeIndex(num_regimes) {
+        for (int label : labels) {
+            append(label);
+        }
+    }
+
+    void append(int label) {
+        if (label < 0 || static_cast<size_t>(label) >= num_regimes_) {
+            throw std::out_of_range("Regime label out of range");
+        }
+
+        if (!spans_.empty() && spans_.back().regime == label) {
+            spans_.back().length++;
+        } else {
+            regime_spans_[label].push_back(spans_.size());
+            spans_.push_back(Span{size_, 1, label});
+        }
+
+        if (size_ > 0) {
+            transitions_[last_ * num_regimes_ + label]++;
+        }
+        durations_[label]++;
+        last_ = label;
+        size_++;
+    }
+
+    size_t size() const { return size_; }
+    size_t num_regimes() const { return num_regimes_; }
+
+    const std::vector<Span>& spans() const { return spans_; }
+
+    // Indices into spans() belonging to the regime, in time order
+    const std::vector<size_t>& spans_of(int regime) const { return regime_spans_.at(regime); }
+
+    size_t duration(int regime) const { return durations_.at(regime); }
+
+    // Number of consecutive (from, to) label pairs; the diagonal measures persistence
+    size_t transitions(int from, int to) const {
+        return transitions_.at(static_cast<size_t>(from) * num_regimes_ + to);
+    }
+
+    int label_at(size_t i) const {
+        if (i >= size_) throw std::out_of_range("Index out of bounds");
+        auto it = std::upper_bound(spans_.begin(), spans_.end(), i,
+                                   [](size_t idx, const Span& s) { return idx < s.start; });
+        return std::prev(it)->regime;
+    }
+
+    // Calls f(value) for every element of an aligned series that falls in the
+    // regime. Elements past the end of the series are ignored.
+    template <typename F>
+    void for_each(int regime, const std::vector<double>& values, F&& f) const {
+        for (size_t s : spans_of(regime)) {
+            const Span& span = spans_[s];
+            size_t end = std::min(span.start + span.length, values.size());
+            for (size_t i = span.start; i < end; ++i) {
+                f(values[i]);
+            }
+        }
+    }
+
+    // Single time-ordered pass: calls f(regime, begin, length) for each span
+    // of an aligned series, clipped to the series length
+    template <typename F>
+    void for_each_span(const std::vector<double>& values, F&& f) const {
+        for (const Span& span : spans_) {
+            if (span.start >= values.size()) break;
+            size_t length = std::min(span.length, values.size() - span.start);
+            f(span.regime, values.data() + span.start, length);
+        }
+    }
+
+private:
+    size_t num_regimes_;
+    size_t size_ = 0;
+    int last_ = -1;
+    std::vector<Span> spans_;
+    std::vector<size_t> durations_;
+    std::vector<std::vector<size_t>> regime_spans_;
+    std::vector<size_t> transitions_;
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include "strategies/Strategy.hpp"
+#include <string>
+#include <vector>
+
+// Out-of-core execution of the regime pipeline. Prices are streamed from disk
+// in blocks of chunk_rows; rolling feature windows, KMeans sufficient
+// statistics and backtest state are carried across block boundaries, so
+// resident memory is O(chunk_rows) regardless of history length. Results
+// match the in-memory path for the same seed.
+class ChunkedPipeline {
+public:
+    struct Config {
+        std::string path;
+        std::string price_col = "Close";
+        size_t chunk_rows = 65536;
+        size_t vol_window = 20;
+        size_t dd_window = 20;
+        size_t num_regimes = 3;
+        size_t max_iters = 100;
+        double tolerance = 1e-4;
+        unsigned int seed = 42;
+        bool single_precision = false;  // stream feature blocks to K-Means as float
+    };
+
+    struct StrategyResult {
+        std::string name;
+        double total_return = 0.0;
+        double annual_return = 0.0;
+        double sharpe = 0.0;
+        double max_drawdown = 0.0;
+        std::vector<size_t> regime_days;
+        std::vector<double> regime_annual_return;
+        std::vector<double> regime_sharpe;
+    };
+
+    struct Result {
+        size_t price_rows = 0;
+        size_t feature_rows = 0;
+        double inertia = 0.0;
+        std::vector<size_t> regime_counts;
+        std::vector<size_t> regime_episodes;  // runs of consecutive rows in the regime
+        std::vector<double> regime_avg_vol;
+        std::vector<double> regime_avg_dd;
+        std::vector<std::vector<size_t>> transitions;
+        std::vector<StrategyResult> strategies;
+    };
+
+    static Result run(const Config& config, const std::vector<Strategy*>& strategies);
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include "core/Matrix.hpp"
+#include "core/TimeSeries.hpp"
+#include "backtest/Backtester.hpp"
+#include "models/RegimeIndex.hpp"
+#include <atomic>
+#include <memory>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Everything a query needs, built once at startup and read-only afterwards.
+// Features come from RegimeFeatures, as in the in-memory CLI run, so a daemon
+// started with the same files, regime count, seed and precision answers with
+// the same regimes.
+struct AnalysisContext {
+    std::string source;  // first (traded) price file
+    size_t num_assets = 1;
+    TimeSeries prices;
+    Matrix features{0, 0};
+    std::vector<std::string> feature_dates;
+    std::vector<int> regimes;
+    std::unique_ptr<RegimeIndex> regime_index;
+    Matrix centroids{0, 0};
+    double inertia = 0.0;
+    std::unordered_map<std::string, size_t> row_by_date;
+
+    // paths[0] is the traded series; further files add cross-asset
+    // correlation features. single_precision clusters float features.
+    static std::unique_ptr<AnalysisContext> load(const std::vector<std::string>& paths,
+                                                 size_t num_regimes, unsigned int seed,
+                                                 bool single_precision = false);
+};
+
+// What the server keeps per backtested strategy spec: streamed metrics only,
+// never the equity, return or signal series
+struct BacktestSummary {
+    explicit BacktestSummary(const RegimeIndex& index) : regimes(index) {}
+
+    MetricsSink overall;
+    RegimeMetricsSink regimes;
+};
+
+// Resident query server over a Unix domain socket. Requests are single lines,
+// responses single-line JSON:
+//   PING
+//   INFO
+//   REGIME <date>
+//   BACKTEST <strategy> [params...]        e.g. BACKTEST momentum 20
+//   REGIME_METRICS <strategy> [params...]  e.g. REGIME_METRICS meanrev 20 1.5
+//   QUIT
+// Strategies: buyhold | momentum <lookback> | meanrev <window> [threshold].
+// One thread polls every connection and hands complete request lines to a
+// fixed worker pool, so idle connections hold no worker. Requests on one
+// connection are answered in order. Backtest summaries are kept in an LRU
+// cache of cache_capacity strategy specs.
+class AnalysisServer {
+public:
+    AnalysisServer(std::unique_ptr<AnalysisContext> context, std::string socket_path,
+                   size_t num_workers = 0, size_t cache_capacity = 256);
+    ~AnalysisServer();
+
+    // Blocks accepting connections until stop() is called (returns at once if
+    // it already was), then joins the workers and removes the socket file
+    void serve();
+    void stop();
+
+    // Routes SIGINT and SIGTERM to stop() on this server
+    void stop_on_signals();
+
+    // Answers one request line; exposed so the protocol can be driven in-process
+    std::string handle(const std::string& request);
+
+private:
+    std::unique_ptr<AnalysisContext> context_;
+    std::string socket_path_;
+    size_t num_workers_;
+    int listen_fd_ = -1;
+    int wake_fds_[2] = {-1, -1};  // pipe that interrupts poll()
+    std::atomic<bool> running_{true};  // cleared once by stop(), even before serve()
+
+    using CacheEntry = std::pair<std::string, std::shared_ptr<const BacktestSummary>>;
+    size_t cache_capacity_;
+    std::mutex cache_mutex_;
+    std::list<CacheEntry> cache_lru_;  // most recently used first
+    std::unordered_map<std::string, std::list<CacheEntry>::iterator> cache_index_;
+
+    std::shared_ptr<const BacktestSummary> backtest(const std::vector<std::string>& args,
+                                                    std::string& name);
+    void wake();
+};
@@ -14,5 +14,8 @@ public:
         return signals;
     }
 
+    void reset() override {}
+    double on_price(double) override { return 1.0; }
+
     std::string name() const override { return "Buy & Hold"; }
 };
\ No newline at end of file
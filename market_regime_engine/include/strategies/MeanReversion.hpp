@@ -1,6 +1,7 @@
 #pragma once
 #include "strategies/Strategy.hpp"
 #include <cmath>
+#include <vector>
 
 class MeanReversion : public Strategy {
 public:
@@ -54,6 +55,45 @@ public:
         return signals;
     }
 
+    void reset() override {
+        history_.clear();
+        head_ = 0;
+    }
+
+    // Same summation order as generate_signals, oldest price first, so the
+    // signals match bit for bit
+    double on_price(double price) override {
+        if (history_.size() < window_) {
+            history_.push_back(price);
+            return 0.0;
+        }
+        if (window_ == 0) return 0.0;  // an empty window has a zero z-score
+
+        double mean = 0.0;
+        for (size_t k = 0; k < window_; ++k) {
+            mean += history_[(head_ + k) % window_];
+        }
+        mean /= window_;
+
+        double variance = 0.0;
+        for (size_t k = 0; k < window_; ++k) {
+            double diff = history_[(head_ + k) % window_] - mean;
+            variance += diff * diff;
+        }
+        variance /= (window_ - 1);
+        double std_dev = std::sqrt(variance);
+
+        history_[head_] = price;
+        head_ = (head_ + 1) % window_;
+
+        double z_score = (std_dev > 1e-8) ? (price - mean) / std_dev : 0.0;
+        if (z_score > threshold_) return -1.0;
+        if (z_score < -threshold_) return 1.0;
+        return 0.0;
+    }
+
+    size_t warmup() const override { return window_; }
+
     std::string name() const override { 
         return "MeanReversion(" + std::to_string(window_) + ")"; 
     }
@@ -61,4 +101,6 @@ public:
 private:
     size_t window_;
     double threshold_;
+    std::vector<double> history_;  // last window_ prices, oldest at head_
+    size_t head_ = 0;
 };
\ No newline at end of file
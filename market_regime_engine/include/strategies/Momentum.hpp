@@ -1,5 +1,6 @@
 #pragma once
 #include "strategies/Strategy.hpp"
+#include <vector>
 
 class Momentum : public Strategy {
 public:
@@ -30,10 +31,32 @@ public:
         return signals;
     }
 
+    void reset() override {
+        history_.clear();
+        head_ = 0;
+    }
+
+    double on_price(double price) override {
+        if (history_.size() < lookback_) {
+            history_.push_back(price);
+            return 0.0;
+        }
+        if (lookback_ == 0) return -1.0;  // a zero-day change is never positive
+
+        double price_change = price - history_[head_];
+        history_[head_] = price;
+        head_ = (head_ + 1) % lookback_;
+        return (price_change > 0) ? 1.0 : -1.0;
+    }
+
+    size_t warmup() const override { return lookback_; }
+
     std::string name() const override { 
         return "Momentum(" + std::to_string(lookback_) + ")"; 
     }
 
 private:
     size_t lookback_;
+    std::vector<double> history_;  // last lookback_ prices, oldest at head_
+    size_t head_ = 0;
 };
\ No newline at end of file
@@ -7,4 +7,13 @@ public:
     virtual ~Strategy() = default;
     virtual TimeSeries generate_signals(const TimeSeries& prices) = 0;
     virtual std::string name() const = 0;
-};
\ No newline at end of file
+
+    // Streaming form of generate_signals: reset() starts a new series and
+    // on_price() returns the signal for each price in turn, identical to the
+    // batch signal at the same index. State is bounded by warmup().
+    virtual void reset() = 0;
+    virtual double on_price(double price) = 0;
+
+    // Number of preceding prices a signal depends on
+    virtual size_t warmup() const { return 0; }
+};
@@ -0,0 +1,534 @@
+#include "server/AnalysisServer.hpp"
+#include "data/CSVReader.hpp"
+#include "features/RegimeFeatures.hpp"
+#include "models/KMeans.hpp"
+#include "strategies/BuyHold.hpp"
+#include "strategies/Momentum.hpp"
+#include "strategies/MeanReversion.hpp"
+#include "backtest/Metrics.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// Server that SIGINT/SIGTERM stop, set by stop_on_signals()
+static std::atomic<AnalysisServer*> signal_target{nullptr};
+
+// Clusters features stored as T; replies read them back as double, so they
+// report exactly the values K-Means saw
+template <typename T>
+static void fit_regimes(AnalysisContext& ctx, const std::vector<TimeSeries>& assets,
+                        size_t num_regimes, unsigned int seed) {
+    BasicMatrix<T> X = RegimeFeatures::build<T>(assets, 20, &ctx.feature_dates);
+
+    KMeans km(num_regimes, 100, 1e-4, seed);
+    ctx.regimes = km.fit_predict(X);
+    ctx.centroids = km.get_centroids();
+    ctx.inertia = km.get_inertia();
+
+    if constexpr (std::is_same<T, double>::value) {
+        ctx.features = std::move(X);
+    } else {
+        ctx.features = Matrix(X);
+    }
+}
+
+std::unique_ptr<AnalysisContext> AnalysisContext::load(const std::vector<std::string>& paths,
+                                                       size_t num_regimes, unsigned int seed,
+                                                       bool single_precision) {
+    if (paths.empty()) throw std::invalid_argument("Need at least one price file");
+
+    auto ctx = std::make_unique<AnalysisContext>();
+    ctx->source = paths.front();
+    ctx->num_assets = paths.size();
+
+    std::vector<TimeSeries> assets;
+    for (const auto& path : paths) {
+        assets.push_back(CSVReader::read_price_series(path));
+    }
+    CSVReader::align_on_dates(assets);
+
+    if (single_precision) {
+        fit_regimes<float>(*ctx, assets, num_regimes, seed);
+    } else {
+        fit_regimes<double>(*ctx, assets, num_regimes, seed);
+    }
+    ctx->prices = std::move(assets.front());
+
+    for (size_t i = 0; i < ctx->feature_dates.size(); ++i) {
+        ctx->row_by_date[ctx->feature_dates[i]] = i;
+    }
+    ctx->regime_index = std::make_unique<RegimeIndex>(ctx->regimes, num_regimes);
+    return ctx;
+}
+
+static std::string json_string(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) out += c;
+    }
+    return out + "\"";
+}
+
+static std::string json_error(const std::string& message) {
+    return "{\"ok\":false,\"error\":" + json_string(message) + "}";
+}
+
+static std::unique_ptr<Strategy> make_strategy(const std::vector<std::string>& args, std::string& key) {
+    if (args.size() < 2) {
+        throw std::invalid_argument("missing strategy");
+    }
+
+    std::string kind = args[1];
+    std::transform(kind.begin(), kind.end(), kind.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (kind == "buyhold") {
+        key = "buyhold";
+        return std::make_unique<BuyHold>();
+    }
+    if (kind == "momentum") {
+        size_t lookback = args.size() > 2 ? std::stoul(args[2]) : 20;
+        if (lookback == 0) throw std::invalid_argument("lookback must be positive");
+        key = "momentum " + std::to_string(lookback);
+        return std::make_unique<Momentum>(lookback);
+    }
+    if (kind == "meanrev") {
+        size_t window = args.size() > 2 ? std::stoul(args[2]) : 20;
+        double threshold = args.size() > 3 ? std::stod(args[3]) : 1.0;
+        if (window < 2) throw std::invalid_argument("window must be at least 2");
+        std::ostringstream k;
+        k << "meanrev " << window << " " << std::setprecision(17) << threshold;
+        key = k.str();
+        return std::make_unique<MeanReversion>(window, threshold);
+    }
+    throw std::invalid_argument("unknown strategy: " + args[1]);
+}
+
+AnalysisServer::AnalysisServer(std::unique_ptr<AnalysisContext> context, std::string socket_path,
+                               size_t num_workers, size_t cache_capacity)
+    : context_(std::move(context)),
+      socket_path_(std::move(socket_path)),
+      num_workers_(num_workers),
+      cache_capacity_(std::max<size_t>(1, cache_capacity)) {
+    if (num_workers_ == 0) {
+        num_workers_ = std::max(4u, std::thread::hardware_concurrency());
+    }
+}
+
+AnalysisServer::~AnalysisServer() {
+    AnalysisServer* self = this;
+    signal_target.compare_exchange_strong(self, nullptr);
+    stop();
+}
+
+std::shared_ptr<const BacktestSummary> AnalysisServer::backtest(
+    const std::vector<std::string>& args, std::string& name) {
+    std::string key;
+    auto strategy = make_strategy(args, key);
+    name = strategy->name();
+
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        auto it = cache_index_.find(key);
+        if (it != cache_index_.end()) {
+            cache_lru_.splice(cache_lru_.begin(), cache_lru_, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Computed outside the lock; a racing duplicate just loses the insert
+    auto summary = std::make_shared<BacktestSummary>(*context_->regime_index);
+    MultiSink sink({&summary->overall, &summary->regimes});
+    Backtester::run(context_->prices, *strategy, sink);
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    auto it = cache_index_.find(key);
+    if (it != cache_index_.end()) {
+        return it->second->second;  // a racing request got there first
+    }
+    cache_lru_.emplace_front(key, std::move(summary));
+    cache_index_[key] = cache_lru_.begin();
+    if (cache_lru_.size() > cache_capacity_) {
+        cache_index_.erase(cache_lru_.back().first);
+        cache_lru_.pop_back();
+    }
+    return cache_lru_.front().second;
+}
+
+std::string AnalysisServer::handle(const std::string& request) {
+    std::istringstream in(request);
+    std::vector<std::string> args;
+    std::string token;
+    while (in >> token) {
+        args.push_back(token);
+    }
+    if (args.empty()) return json_error("empty request");
+
+    std::string command = args[0];
+    std::transform(command.begin(), command.end(), command.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+    std::ostringstream out;
+    out << std::setprecision(10);
+
+    try {
+        const AnalysisContext& ctx = *context_;
+
+        if (command == "PING") {
+            return "{\"ok\":true,\"pong\":true}";
+        }
+
+        if (command == "INFO") {
+            out << "{\"ok\":true,\"source\":" << json_string(ctx.source)
+                << ",\"assets\":" << ctx.num_assets
+                << ",\"prices\":" << ctx.prices.size()
+                << ",\"feature_rows\":" << ctx.features.rows
+                << ",\"regimes\":" << ctx.regime_index->num_regimes()
+                << ",\"first_date\":" << json_string(ctx.feature_dates.empty() ? "" : ctx.feature_dates.front())
+                << ",\"last_date\":" << json_string(ctx.feature_dates.empty() ? "" : ctx.feature_dates.back())
+                << ",\"inertia\":" << ctx.inertia << "}";
+            return out.str();
+        }
+
+        if (command == "REGIME") {
+            if (args.size() < 2) return json_error("usage: REGIME <date>");
+            auto it = ctx.row_by_date.find(args[1]);
+            if (it == ctx.row_by_date.end()) return json_error("unknown date: " + args[1]);
+
+            size_t row = it->second;
+            out << "{\"ok\":true,\"date\":" << json_string(args[1])
+                << ",\"regime\":" << ctx.regimes[row]
+                << ",\"volatility\":" << ctx.features(row, 0)
+                << ",\"drawdown\":" << ctx.features(row, 1);
+            if (ctx.features.cols > 2) {
+                out << ",\"correlation\":" << ctx.features(row, 2)
+                    << ",\"eigenvalue_share\":" << ctx.features(row, 3);
+            }
+            out << "}";
+            return out.str();
+        }
+
+        if (command == "BACKTEST") {
+            std::string name;
+            auto result = backtest(args, name);
+            out << "{\"ok\":true,\"strategy\":" << json_string(name)
+                << ",\"total_return\":" << result->overall.total_return()
+                << ",\"annual_return\":" << result->overall.annual_return()
+                << ",\"sharpe\":" << result->overall.sharpe()
+                << ",\"max_drawdown\":" << result->overall.max_drawdown() << "}";
+            return out.str();
+        }
+
+        if (command == "REGIME_METRICS") {
+            std::string name;
+            auto result = backtest(args, name);
+
+            const auto& by_regime = result->regimes.by_regime();
+            out << "{\"ok\":true,\"strategy\":" << json_string(name) << ",\"regimes\":[";
+            for (size_t r = 0; r < by_regime.size(); ++r) {
+                if (r > 0) out << ",";
+                out << "{\"regime\":" << r
+                    << ",\"days\":" << by_regime[r].count()
+                    << ",\"annual_return\":" << by_regime[r].annual_return()
+                    << ",\"sharpe\":" << by_regime[r].sharpe() << "}";
+            }
+            out << "]}";
+            return out.str();
+        }
+    } catch (const std::exception& e) {
+        return json_error(e.what());
+    }
+
+    return json_error("unknown command: " + args[0]);
+}
+
+#ifndef _WIN32
+
+// A client connection owned by the poll loop. While `busy` a worker is
+// answering one of its lines and the loop neither reads nor closes it.
+struct ClientConnection {
+    explicit ClientConnection(int fd) : fd(fd) {}
+
+    int fd;
+    std::string buffer;
+    bool busy = false;
+    bool failed = false;
+};
+
+void AnalysisServer::wake() {
+    if (wake_fds_[1] >= 0) {
+        char c = 0;
+        ssize_t n = ::write(wake_fds_[1], &c, 1);
+        (void)n;  // a full pipe already guarantees a wake-up
+    }
+}
+
+void AnalysisServer::serve() {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path_.size() >= sizeof(addr.sun_path)) {
+        throw std::invalid_argument("Socket path too long: " + socket_path_);
+    }
+    std::copy(socket_path_.begin(), socket_path_.end(), addr.sun_path);
+
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error("Cannot create socket");
+    }
+
+    auto fail = [&](const std::string& message) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        throw std::runtime_error(message);
+    };
+
+    // Only a stale socket may be replaced: anything else at the path is the
+    // user's file, and a socket that still accepts connections belongs to a
+    // running server
+    struct stat st;
+    if (::lstat(socket_path_.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            fail("Refusing to replace non-socket file: " + socket_path_);
+        }
+        int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        bool live = probe >= 0 && ::connect(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        int error = errno;
+        if (probe >= 0) ::close(probe);
+        if (live) {
+            fail("A server is already listening on " + socket_path_);
+        }
+        if (error != ECONNREFUSED) {
+            fail("Cannot check existing socket " + socket_path_ + ": " + std::strerror(error));
+        }
+        ::unlink(socket_path_.c_str());
+    }
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listen_fd_, 128) < 0 || ::pipe(wake_fds_) < 0) {
+        fail("Cannot listen on " + socket_path_);
+    }
+    ::fcntl(wake_fds_[0], F_SETFL, O_NONBLOCK);
+    ::fcntl(wake_fds_[1], F_SETFL, O_NONBLOCK);
+
+    using Job = std::pair<std::shared_ptr<ClientConnection>, std::string>;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::queue<Job> jobs;
+    std::vector<std::shared_ptr<ClientConnection>> finished;
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < num_workers_; ++i) {
+        workers.emplace_back([&]() {
+            for (;;) {
+                Job job;
+                {
+                    std::unique_lock<std::mutex> lock(queue_mutex);
+                    queue_cv.wait(lock, [&]() { return !jobs.empty() || !running_; });
+                    if (jobs.empty()) return;
+                    job = std::move(jobs.front());
+                    jobs.pop();
+                }
+
+                ClientConnection& conn = *job.first;
+                std::string response = handle(job.second) + "\n";
+                size_t sent = 0;
+                while (sent < response.size()) {
+                    ssize_t n = ::send(conn.fd, response.data() + sent, response.size() - sent,
+                                       MSG_NOSIGNAL);
+                    if (n <= 0) {
+                        conn.failed = true;
+                        break;
+                    }
+                    sent += static_cast<size_t>(n);
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex);
+                    finished.push_back(job.first);
+                }
+                wake();
+            }
+        });
+    }
+
+    std::cout << "Serving on " << socket_path_ << " with " << num_workers_ << " workers" << std::endl;
+
+    std::map<int, std::shared_ptr<ClientConnection>> connections;
+
+    auto close_connection = [&](const std::shared_ptr<ClientConnection>& conn) {
+        ::close(conn->fd);
+        connections.erase(conn->fd);
+    };
+
+    // Hands the next complete line to the workers; false if the connection
+    // was closed
+    auto dispatch = [&](const std::shared_ptr<ClientConnection>& conn) {
+        size_t nl = conn->buffer.find('\n');
+        if (nl == std::string::npos) {
+            if (conn->buffer.size() > 64 * 1024) {
+                close_connection(conn);  // no newline in 64 KiB: not a client of this protocol
+                return false;
+            }
+            return true;
+        }
+
+        std::string line = conn->buffer.substr(0, nl);
+        conn->buffer.erase(0, nl + 1);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        std::string upper = line;
+        std::transform(upper.begin(), upper.end(), upper.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        if (upper == "QUIT") {
+            close_connection(conn);
+            return false;
+        }
+
+        conn->busy = true;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            jobs.emplace(conn, std::move(line));
+        }
+        queue_cv.notify_one();
+        return true;
+    };
+
+    std::vector<pollfd> fds;
+    char chunk[4096];
+
+    while (running_) {
+        std::vector<std::shared_ptr<ClientConnection>> done;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            done.swap(finished);
+        }
+        for (auto& conn : done) {
+            conn->busy = false;
+            if (conn->failed) {
+                close_connection(conn);
+            } else {
+                dispatch(conn);
+            }
+        }
+
+        fds.clear();
+        fds.push_back(pollfd{listen_fd_, POLLIN, 0});
+        fds.push_back(pollfd{wake_fds_[0], POLLIN, 0});
+        for (const auto& entry : connections) {
+            if (!entry.second->busy) {
+                fds.push_back(pollfd{entry.first, POLLIN, 0});
+            }
+        }
+
+        if (::poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (fds[1].revents) {
+            while (::read(wake_fds_[0], chunk, sizeof(chunk)) > 0) {
+            }
+        }
+
+        for (size_t i = 2; i < fds.size(); ++i) {
+            if (!fds[i].revents) continue;
+            auto conn = connections.at(fds[i].fd);
+            ssize_t n = ::recv(conn->fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                close_connection(conn);
+                continue;
+            }
+            conn->buffer.append(chunk, static_cast<size_t>(n));
+            dispatch(conn);
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd >= 0) {
+                // A client that stops reading must not pin a worker in send()
+                timeval timeout{5, 0};
+                ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                connections[fd] = std::make_shared<ClientConnection>(fd);
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        running_ = false;
+    }
+    queue_cv.notify_all();
+    for (auto& w : workers) {
+        w.join();
+    }
+    for (auto& entry : connections) {
+        ::close(entry.first);
+    }
+
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    ::unlink(socket_path_.c_str());
+    for (int& fd : wake_fds_) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+// stop() only stores an atomic flag and writes the wake pipe, both safe in
+// a signal handler; the pipe wakes poll() whichever thread takes the signal
+static void on_stop_signal(int) {
+    if (AnalysisServer* server = signal_target.load()) {
+        server->stop();
+    }
+}
+
+void AnalysisServer::stop_on_signals() {
+    signal_target = this;
+    struct sigaction action {};
+    action.sa_handler = on_stop_signal;
+    sigemptyset(&action.sa_mask);
+    ::sigaction(SIGINT, &action, nullptr);
+    ::sigaction(SIGTERM, &action, nullptr);
+}
+
+void AnalysisServer::stop() {
+    running_ = false;
+    wake();
+}
+
+#else
+
+void AnalysisServer::wake() {}
+
+void AnalysisServer::serve() {
+    throw std::runtime_error("Server mode requires Unix domain sockets");
+}
+
+void AnalysisServer::stop_on_signals() {}
+
+void AnalysisServer::stop() {}
+
+#endif
@@ -0,0 +1,143 @@
+#include "backtest/Bootstrap.hpp"
+#include "backtest/Metrics.hpp"
+#include "core/CounterRng.hpp"
+#include "core/ParallelFor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// One regime episode (RegimeIndex span) within a regime's pooled returns.
+// Episodes own max(length, L) sampling slots, which gives every return the
+// same expected coverage by drawn blocks.
+struct Episode {
+    size_t start;
+    size_t length;
+    size_t slot;
+};
+
+static double percentile(std::vector<double>& sorted_values, double q) {
+    if (sorted_values.empty()) return 0.0;
+    double pos = q * (sorted_values.size() - 1);
+    size_t lo = static_cast<size_t>(pos);
+    size_t hi = std::min(lo + 1, sorted_values.size() - 1);
+    double frac = pos - lo;
+    return sorted_values[lo] + frac * (sorted_values[hi] - sorted_values[lo]);
+}
+
+std::vector<Bootstrap::RegimeInterval> Bootstrap::regime_intervals(const TimeSeries& returns,
+                                                                   const RegimeIndex& regimes,
+                                                                   const Config& config) {
+    if (config.replicates == 0 || config.block_length == 0 || config.batch_size == 0) {
+        throw std::invalid_argument("Bootstrap replicates, block length and batch size must be positive");
+    }
+    if (config.confidence <= 0.0 || config.confidence >= 1.0) {
+        throw std::invalid_argument("Bootstrap confidence must be in (0, 1)");
+    }
+
+    // Gather each regime's returns into one contiguous pool so the resampling
+    // loop only ever reads sequential memory.
+    const size_t num_regimes = regimes.num_regimes();
+    std::vector<size_t> counts(num_regimes, 0);
+    regimes.for_each_span(returns.values, [&](int regime, const double*, size_t n) {
+        counts[regime] += n;
+    });
+
+    std::vector<size_t> offsets(num_regimes + 1, 0);
+    for (size_t r = 0; r < num_regimes; ++r) {
+        offsets[r + 1] = offsets[r] + counts[r];
+    }
+
+    const size_t B = config.replicates;
+    const size_t L = config.block_length;
+
+    std::vector<double> pool(offsets[num_regimes]);
+    std::vector<size_t> cursor(offsets.begin(), offsets.end() - 1);
+    std::vector<std::vector<Episode>> episodes(num_regimes);
+    std::vector<std::vector<uint32_t>> slot_episode(num_regimes);  // slot -> index into episodes
+    regimes.for_each_span(returns.values, [&](int regime, const double* values, size_t n) {
+        std::copy(values, values + n, pool.begin() + cursor[regime]);
+        auto& slot_map = slot_episode[regime];
+        episodes[regime].push_back(Episode{cursor[regime] - offsets[regime], n, slot_map.size()});
+        slot_map.insert(slot_map.end(), std::max(n, L), static_cast<uint32_t>(episodes[regime].size() - 1));
+        cursor[regime] += n;
+    });
+    std::vector<double> sharpe_samples(num_regimes * B, 0.0);
+    std::vector<double> annual_samples(num_regimes * B, 0.0);
+
+    const size_t num_batches = (B + config.batch_size - 1) / config.batch_size;
+    parallel_for(num_batches, config.num_threads, [&](size_t batch) {
+        size_t begin = batch * config.batch_size;
+        size_t end = std::min(begin + config.batch_size, B);
+
+        for (size_t b = begin; b < end; ++b) {
+            for (size_t r = 0; r < num_regimes; ++r) {
+                size_t len = counts[r];
+                if (len < 2) continue;
+
+                const double* values = pool.data() + offsets[r];
+                const Episode* eps = episodes[r].data();
+                const std::vector<uint32_t>& slot_map = slot_episode[r];
+                CounterRng rng(config.seed, b * num_regimes + r);
+
+                double sum = 0.0;
+                double sum_sq = 0.0;
+                for (size_t drawn = 0; drawn < len;) {
+                    size_t slot = rng.uniform_index(static_cast<uint32_t>(slot_map.size()));
+                    const Episode& ep = eps[slot_map[slot]];
+
+                    // Blocks stay inside one episode: circular within it
+                    // when it spans at least L returns, else the whole
+                    // episode
+                    const double* episode = values + ep.start;
+                    size_t offset = ep.length >= L ? slot - ep.slot : 0;
+                    size_t take = std::min(std::min(L, ep.length), len - drawn);
+
+                    size_t first = std::min(take, ep.length - offset);
+                    for (size_t t = 0; t < first; ++t) {
+                        double x = episode[offset + t];
+                        sum += x;
+                        sum_sq += x * x;
+                    }
+                    for (size_t t = 0; t < take - first; ++t) {
+                        double x = episode[t];
+                        sum += x;
+                        sum_sq += x * x;
+                    }
+                    drawn += take;
+                }
+
+                double mean = sum / len;
+                double variance = std::max(0.0, (sum_sq - sum * mean) / (len - 1));
+                sharpe_samples[r * B + b] = Metrics::sharpe_from_moments(mean, std::sqrt(variance));
+                annual_samples[r * B + b] = mean * 252;
+            }
+        }
+    });
+
+    double alpha = (1.0 - config.confidence) / 2.0;
+    std::vector<RegimeInterval> intervals(num_regimes);
+
+    for (size_t r = 0; r < num_regimes; ++r) {
+        RegimeInterval& out = intervals[r];
+        out.regime = r;
+        out.observations = counts[r];
+        if (counts[r] < 2) continue;
+
+        TimeSeries regime_returns;
+        regime_returns.values.assign(pool.begin() + offsets[r], pool.begin() + offsets[r + 1]);
+        out.sharpe.estimate = Metrics::sharpe(regime_returns);
+        out.annual_return.estimate = Metrics::annual_return(regime_returns);
+
+        std::vector<double> sharpe(sharpe_samples.begin() + r * B, sharpe_samples.begin() + (r + 1) * B);
+        std::vector<double> annual(annual_samples.begin() + r * B, annual_samples.begin() + (r + 1) * B);
+        std::sort(sharpe.begin(), sharpe.end());
+        std::sort(annual.begin(), annual.end());
+
+        out.sharpe.lower = percentile(sharpe, alpha);
+        out.sharpe.upper = percentile(sharpe, 1.0 - alpha);
+        out.annual_return.lower = percentile(annual, alpha);
+        out.annual_return.upper = percentile(annual, 1.0 - alpha);
+    }
+
+    return intervals;
+}
@@ -3,6 +3,8 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <cstdio>
+#include <unordered_map>
 
 // Helper function to parse CSV line properly handling quoted fields
 std::vector<std::string> parse_csv_line(const std::string& line) {
@@ -41,6 +43,62 @@ std::string clean_value(std::string value) {
     return value;
 }
 
+// Sortable key for "MM/DD/YYYY" or "YYYY-MM-DD[ HH:MM[:SS]]" dates; 0 if unrecognised
+long long date_key(const std::string& date) {
+    int y = 0, m = 0, d = 0, hh = 0, mm = 0, ss = 0;
+    if (std::sscanf(date.c_str(), "%d-%d-%d %d:%d:%d", &y, &m, &d, &hh, &mm, &ss) >= 3 ||
+        std::sscanf(date.c_str(), "%d-%d-%dT%d:%d:%d", &y, &m, &d, &hh, &mm, &ss) >= 3) {
+    } else if (std::sscanf(date.c_str(), "%d/%d/%d", &m, &d, &y) != 3) {
+        return 0;
+    }
+    return ((((y * 100LL + m) * 100 + d) * 100 + hh) * 100 + mm) * 100 + ss;
+}
+
+// Locates the price and date columns from the header line
+void locate_columns(const std::string& header_line, const std::string& price_col,
+                    int& price_idx, int& date_idx) {
+    auto headers = parse_csv_line(header_line);
+    for (auto& h : headers) {
+        h = clean_value(h);
+    }
+
+    price_idx = -1;
+    date_idx = -1;
+    for (size_t i = 0; i < headers.size(); ++i) {
+        if (headers[i] == price_col) {
+            price_idx = static_cast<int>(i);
+        }
+        if (headers[i] == "Date" || headers[i] == "date") {
+            date_idx = static_cast<int>(i);
+        }
+    }
+
+    if (price_idx == -1) {
+        throw std::runtime_error("Price column not found: " + price_col);
+    }
+}
+
+// Parses one data row and appends it to the series
+void append_row(std::string line, int price_idx, int date_idx, TimeSeries& series) {
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+    auto fields = parse_csv_line(line);
+    
+    std::string date_str;
+    double price = 0.0;
+
+    if (static_cast<int>(fields.size()) > price_idx && price_idx >= 0) {
+        price = std::stod(clean_value(fields[price_idx]));
+    }
+    if (date_idx >= 0 && static_cast<int>(fields.size()) > date_idx) {
+        date_str = clean_value(fields[date_idx]);
+    }
+
+    series.values.push_back(price);
+    series.dates.push_back(date_str);
+}
+
 TimeSeries CSVReader::read_price_series(const std::string& path, 
                                        const std::string& price_col) {
     std::ifstream file(path);
@@ -55,43 +113,126 @@ TimeSeries CSVReader::read_price_series(const std::string& path,
         throw std::runtime_error("Empty file");
     }
 
-    auto headers = parse_csv_line(line);
-    for (auto& h : headers) {
-        h = clean_value(h);
+    int price_idx;
+    int date_idx;
+    locate_columns(line, price_col, price_idx, date_idx);
+
+    while (std::getline(file, line)) {
+        append_row(line, price_idx, date_idx, series);
     }
 
-    int price_idx = -1;
-    int date_idx = -1;
-    for (size_t i = 0; i < headers.size(); ++i) {
-        if (headers[i] == price_col) {
-            price_idx = static_cast<int>(i);
+    std::cout << "Read " << series.size() << " rows from " << path << std::endl;
+
+    // Vendor exports are often newest-first; everything downstream assumes
+    // ascending time.
+    if (series.size() > 1 && date_key(series.dates.front()) > date_key(series.dates.back())) {
+        std::reverse(series.values.begin(), series.values.end());
+        std::reverse(series.dates.begin(), series.dates.end());
+        std::cout << "Reordered newest-first input to ascending time" << std::endl;
+    }
+    return series;
+}
+
+void CSVReader::align_on_dates(std::vector<TimeSeries>& series) {
+    if (series.size() < 2) return;
+
+    std::unordered_map<std::string, size_t> seen;
+    for (const auto& s : series) {
+        for (const auto& d : s.dates) {
+            seen[d]++;
         }
-        if (headers[i] == "Date" || headers[i] == "date") {
-            date_idx = static_cast<int>(i);
+    }
+
+    for (auto& s : series) {
+        TimeSeries aligned;
+        for (size_t i = 0; i < s.size(); ++i) {
+            if (seen[s.dates[i]] == series.size()) {
+                aligned.values.push_back(s.values[i]);
+                aligned.dates.push_back(s.dates[i]);
+            }
         }
+        s = std::move(aligned);
     }
+}
 
-    if (price_idx == -1) {
-        throw std::runtime_error("Price column not found: " + price_col);
+CSVChunkReader::CSVChunkReader(const std::string& path, const std::string& price_col)
+    : path_(path), file_(path, std::ios::binary) {
+    if (!file_.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path);
     }
 
-    while (std::getline(file, line)) {
-        auto fields = parse_csv_line(line);
-        
-        std::string date_str;
-        double price = 0.0;
+    std::string line;
+    if (!std::getline(file_, line)) {
+        throw std::runtime_error("Empty file");
+    }
+
+    locate_columns(line, price_col, price_idx_, date_idx_);
+    data_start_ = file_.tellg();
+
+    file_.seekg(0, std::ios::end);
+    data_end_ = file_.tellg();
+
+    // Compare the first and last rows to detect newest-first files, which are
+    // then read backwards so chunks always arrive in ascending time.
+    if (date_idx_ >= 0) {
+        TimeSeries first;
+        TimeSeries last;
+        rewind();
+        read(first, 1);
+        reverse_ = true;
+        rewind();
+        read(last, 1);
+        reverse_ = first.size() == 1 && last.size() == 1 &&
+                   date_key(first.dates[0]) > date_key(last.dates[0]);
+    }
+    rewind();
+}
+
+bool CSVChunkReader::next_line(std::string& line) {
+    if (!reverse_) {
+        return static_cast<bool>(std::getline(file_, line));
+    }
 
-        if (static_cast<int>(fields.size()) > price_idx && price_idx >= 0) {
-            price = std::stod(clean_value(fields[price_idx]));
+    const std::streamoff block = 1 << 16;
+    for (;;) {
+        size_t nl = pending_.rfind('\n');
+        if (nl != std::string::npos) {
+            line = pending_.substr(nl + 1);
+            pending_.resize(nl);
+            return true;
         }
-        if (date_idx >= 0 && static_cast<int>(fields.size()) > date_idx) {
-            date_str = clean_value(fields[date_idx]);
+        if (read_pos_ == data_start_) {
+            if (pending_.empty()) return false;
+            line.swap(pending_);
+            pending_.clear();
+            return true;
         }
 
-        series.values.push_back(price);
-        series.dates.push_back(date_str);
+        std::streamoff n = std::min<std::streamoff>(block, read_pos_ - data_start_);
+        read_pos_ -= n;
+        std::string bytes(static_cast<size_t>(n), '\0');
+        file_.clear();
+        file_.seekg(read_pos_);
+        file_.read(&bytes[0], n);
+        pending_.insert(0, bytes);
     }
+}
 
-    std::cout << "Read " << series.size() << " rows from " << path << std::endl;
-    return series;
-}
\ No newline at end of file
+size_t CSVChunkReader::read(TimeSeries& chunk, size_t max_rows) {
+    chunk.values.clear();
+    chunk.dates.clear();
+
+    std::string line;
+    while (chunk.size() < max_rows && next_line(line)) {
+        if (line.empty() || line == "\r") continue;
+        append_row(line, price_idx_, date_idx_, chunk);
+    }
+    return chunk.size();
+}
+
+void CSVChunkReader::rewind() {
+    file_.clear();
+    file_.seekg(data_start_);
+    read_pos_ = data_end_;
+    pending_.clear();
+}
@@ -0,0 +1,247 @@
+#include "pipeline/ChunkedPipeline.hpp"
+#include "core/FeatureSource.hpp"
+#include "data/CSVReader.hpp"
+#include "features/Volatility.hpp"
+#include "features/Drawdown.hpp"
+#include "models/KMeans.hpp"
+#include "backtest/Backtester.hpp"
+#include "backtest/Metrics.hpp"
+#include <cmath>
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+
+// Streams prices from disk and emits (volatility, drawdown) feature rows with
+// the same alignment main.cpp uses in memory: row i pairs the i-th rolling
+// volatility with the i-th rolling drawdown. T is the feature storage type;
+// the rolling windows themselves run in double.
+template <typename T>
+class PriceFeatureSource : public BasicFeatureSource<T> {
+public:
+    explicit PriceFeatureSource(const ChunkedPipeline::Config& config)
+        : config_(config),
+          reader_(config.path, config.price_col),
+          vol_(config.vol_window),
+          dd_(config.dd_window),
+          block_(config.chunk_rows, 2) {
+        if (config.chunk_rows == 0) {
+            throw std::invalid_argument("Chunk size must be positive");
+        }
+    }
+
+    size_t cols() const override { return 2; }
+
+    void rewind() override {
+        reader_.rewind();
+        vol_ = RollingVolatility(config_.vol_window);
+        dd_ = RollingDrawdown(config_.dd_window);
+        pending_vol_.clear();
+        pending_dd_.clear();
+        has_prev_ = false;
+        price_rows_ = 0;
+    }
+
+    bool next_block(BasicMatrixView<T>& block) override {
+        while (next_chunk(block)) {
+            if (block.rows > 0) return true;
+        }
+        return false;
+    }
+
+    // Advances one price chunk. The block may be empty while the rolling
+    // windows are still filling.
+    bool next_chunk(BasicMatrixView<T>& block) {
+        if (reader_.read(prices_, config_.chunk_rows) == 0) return false;
+
+        size_t rows = 0;
+        for (size_t i = 0; i < prices_.size(); ++i) {
+            double price = prices_.values[i];
+
+            if (has_prev_) {
+                if (prev_price_ <= 0 || price <= 0) {
+                    throw std::invalid_argument("Prices must be positive");
+                }
+                double vol;
+                if (vol_.push(std::log(price / prev_price_), vol)) {
+                    pending_vol_.push_back(vol);
+                }
+            }
+
+            double dd;
+            if (dd_.push(price, dd)) {
+                pending_dd_.push_back(dd);
+            }
+
+            while (!pending_vol_.empty() && !pending_dd_.empty()) {
+                block_(rows, 0) = static_cast<T>(pending_vol_.front());
+                block_(rows, 1) = static_cast<T>(pending_dd_.front());
+                pending_vol_.pop_front();
+                pending_dd_.pop_front();
+                ++rows;
+            }
+
+            prev_price_ = price;
+            has_prev_ = true;
+        }
+
+        price_rows_ += prices_.size();
+        block = BasicMatrixView<T>{block_.data.data(), rows, 2};
+        return true;
+    }
+
+    const TimeSeries& prices() const { return prices_; }
+    size_t price_rows() const { return price_rows_; }
+
+private:
+    const ChunkedPipeline::Config& config_;
+    CSVChunkReader reader_;
+    RollingVolatility vol_;
+    RollingDrawdown dd_;
+    std::deque<double> pending_vol_;
+    std::deque<double> pending_dd_;
+    BasicMatrix<T> block_;
+    TimeSeries prices_;
+    double prev_price_ = 0.0;
+    bool has_prev_ = false;
+    size_t price_rows_ = 0;
+};
+
+// Streamed backtest of one strategy. Returns wait in `unattributed` until
+// the labelling pass has produced the regime at the same index.
+struct StrategyRun : public BacktestSink {
+    Strategy* strategy;
+    MetricsSink overall;
+    std::deque<double> unattributed;
+    std::vector<ReturnAccumulator> by_regime;
+
+    void begin(const std::string& date, double initial_equity) override {
+        overall.begin(date, initial_equity);
+    }
+
+    void on_bar(size_t index, const std::string& date, double ret, double equity) override {
+        overall.on_bar(index, date, ret, equity);
+        unattributed.push_back(ret);
+    }
+};
+
+template <typename T>
+static ChunkedPipeline::Result run_pipeline(const ChunkedPipeline::Config& config,
+                                            const std::vector<Strategy*>& strategies) {
+    using Result = ChunkedPipeline::Result;
+    using StrategyResult = ChunkedPipeline::StrategyResult;
+
+    const size_t k = config.num_regimes;
+    PriceFeatureSource<T> source(config);
+
+    KMeans km(k, config.max_iters, config.tolerance, config.seed);
+    km.fit(source);
+
+    Result result;
+    result.regime_counts.assign(k, 0);
+    result.regime_episodes.assign(k, 0);
+    result.regime_avg_vol.assign(k, 0.0);
+    result.regime_avg_dd.assign(k, 0.0);
+    result.transitions.assign(k, std::vector<size_t>(k, 0));
+
+    std::vector<std::unique_ptr<StrategyRun>> runs;
+    std::vector<Backtester::Stream> streams;
+    runs.reserve(strategies.size());
+    streams.reserve(strategies.size());
+    for (Strategy* s : strategies) {
+        runs.push_back(std::make_unique<StrategyRun>());
+        runs.back()->strategy = s;
+        runs.back()->by_regime.resize(k);
+        streams.emplace_back(*s, *runs.back());
+    }
+
+    // Labelling pass: assign regimes block by block and attribute each
+    // strategy return to the regime at the same index.
+    std::vector<int> labels(config.chunk_rows);
+    std::deque<int> unattributed_labels;
+    int prev_label = -1;
+
+    BasicMatrixView<T> block;
+    source.rewind();
+    while (source.next_chunk(block)) {
+        km.predict(block, labels.data(), result.inertia);
+
+        for (size_t i = 0; i < block.rows; ++i) {
+            int label = labels[i];
+            result.regime_counts[label]++;
+            result.regime_avg_vol[label] += block.row(i)[0];
+            result.regime_avg_dd[label] += block.row(i)[1];
+            if (prev_label >= 0) {
+                result.transitions[prev_label][label]++;
+            }
+            if (label != prev_label) {
+                result.regime_episodes[label]++;
+            }
+            prev_label = label;
+            if (!runs.empty()) {
+                unattributed_labels.push_back(label);
+            }
+        }
+        result.feature_rows += block.rows;
+
+        const TimeSeries& prices = source.prices();
+        for (auto& stream : streams) {
+            for (size_t j = 0; j < prices.size(); ++j) {
+                if (j < prices.dates.size()) {
+                    stream.push(prices.values[j], prices.dates[j]);
+                } else {
+                    stream.push(prices.values[j]);
+                }
+            }
+        }
+
+        if (!runs.empty()) {
+            size_t pairs = std::min(unattributed_labels.size(), runs.front()->unattributed.size());
+            for (auto& run : runs) {
+                for (size_t t = 0; t < pairs; ++t) {
+                    run->by_regime[unattributed_labels[t]].add(run->unattributed.front());
+                    run->unattributed.pop_front();
+                }
+            }
+            unattributed_labels.erase(unattributed_labels.begin(), unattributed_labels.begin() + pairs);
+        }
+    }
+
+    result.price_rows = source.price_rows();
+
+    for (size_t r = 0; r < k; ++r) {
+        if (result.regime_counts[r] > 0) {
+            result.regime_avg_vol[r] /= result.regime_counts[r];
+            result.regime_avg_dd[r] /= result.regime_counts[r];
+        }
+    }
+
+    for (auto& stream : streams) {
+        stream.finish();
+    }
+
+    for (const auto& run : runs) {
+        StrategyResult sr;
+        sr.name = run->strategy->name();
+        sr.total_return = run->overall.total_return();
+        sr.annual_return = run->overall.annual_return();
+        sr.sharpe = run->overall.sharpe();
+        sr.max_drawdown = run->overall.max_drawdown();
+        for (const auto& acc : run->by_regime) {
+            sr.regime_days.push_back(acc.count());
+            sr.regime_annual_return.push_back(acc.annual_return());
+            sr.regime_sharpe.push_back(acc.sharpe());
+        }
+        result.strategies.push_back(sr);
+    }
+
+    return result;
+}
+
+ChunkedPipeline::Result ChunkedPipeline::run(const Config& config,
+                                             const std::vector<Strategy*>& strategies) {
+    if (config.single_precision) {
+        return run_pipeline<float>(config, strategies);
+    }
+    return run_pipeline<double>(config, strategies);
+}
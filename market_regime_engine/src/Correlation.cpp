@@ -0,0 +1,243 @@
+#include "features/Correlation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Tile edge for the upper-triangle updates: a 64x64 tile of doubles plus the
+// matching input slices stay resident in L1/L2
+static const size_t TILE = 64;
+
+// cross += x x^T - y y^T over the upper triangle (y may be null)
+static void rank2_update(double* cross, const double* x, const double* y, size_t n) {
+    for (size_t ib = 0; ib < n; ib += TILE) {
+        size_t iend = std::min(ib + TILE, n);
+        for (size_t jb = ib; jb < n; jb += TILE) {
+            size_t jend = std::min(jb + TILE, n);
+            for (size_t i = ib; i < iend; ++i) {
+                double* row = cross + i * n;
+                const double xi = x[i];
+                size_t j = std::max(jb, i);
+                if (y) {
+                    const double yi = y[i];
+                    for (; j < jend; ++j) {
+                        row[j] += xi * x[j] - yi * y[j];
+                    }
+                } else {
+                    for (; j < jend; ++j) {
+                        row[j] += xi * x[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+RollingCovariance::RollingCovariance(size_t num_assets, size_t window, size_t refresh_interval)
+    : n_(num_assets),
+      window_(window),
+      refresh_interval_(refresh_interval > 0 ? refresh_interval : 8 * window),
+      buffer_(window * num_assets, 0.0),
+      sums_(num_assets, 0.0),
+      cross_(num_assets * num_assets, 0.0),
+      inv_sd_(num_assets, 0.0),
+      eigvec_(num_assets, num_assets > 0 ? 1.0 / std::sqrt(static_cast<double>(num_assets)) : 0.0),
+      scratch_(num_assets, 0.0),
+      scaled_(num_assets, 0.0) {
+    if (num_assets == 0) throw std::invalid_argument("Need at least one asset");
+    if (window < 2) throw std::invalid_argument("Window must be at least 2");
+}
+
+bool RollingCovariance::push(const double* returns) {
+    double* slot = &buffer_[head_ * n_];
+
+    if (filled_ == window_) {
+        for (size_t i = 0; i < n_; ++i) {
+            sums_[i] += returns[i] - slot[i];
+        }
+        rank2_update(cross_.data(), returns, slot, n_);
+    } else {
+        for (size_t i = 0; i < n_; ++i) {
+            sums_[i] += returns[i];
+        }
+        rank2_update(cross_.data(), returns, nullptr, n_);
+        ++filled_;
+    }
+
+    std::copy(returns, returns + n_, slot);
+    head_ = (head_ + 1) % window_;
+
+    if (filled_ == window_ && ++since_refresh_ >= refresh_interval_) {
+        rebuild();
+    }
+    return filled_ == window_;
+}
+
+void RollingCovariance::rebuild() {
+    std::fill(sums_.begin(), sums_.end(), 0.0);
+    std::fill(cross_.begin(), cross_.end(), 0.0);
+    for (size_t k = 0; k < filled_; ++k) {
+        const double* x = &buffer_[((head_ + k) % window_) * n_];
+        for (size_t i = 0; i < n_; ++i) {
+            sums_[i] += x[i];
+        }
+        rank2_update(cross_.data(), x, nullptr, n_);
+    }
+    since_refresh_ = 0;
+}
+
+double RollingCovariance::covariance(size_t i, size_t j) const {
+    if (i >= n_ || j >= n_) throw std::out_of_range("Asset index out of bounds");
+    if (i > j) std::swap(i, j);
+    double w = static_cast<double>(filled_);
+    return (cross_[i * n_ + j] - sums_[i] * sums_[j] / w) / (w - 1);
+}
+
+void RollingCovariance::update_inverse_sd() {
+    for (size_t i = 0; i < n_; ++i) {
+        double var = covariance(i, i);
+        inv_sd_[i] = (var > 1e-16) ? 1.0 / std::sqrt(var) : 0.0;
+    }
+}
+
+Matrix RollingCovariance::correlation() const {
+    Matrix corr(n_, n_);
+    for (size_t i = 0; i < n_; ++i) {
+        double si = std::sqrt(std::max(0.0, covariance(i, i)));
+        for (size_t j = i; j < n_; ++j) {
+            double sj = std::sqrt(std::max(0.0, covariance(j, j)));
+            double c = (si > 1e-8 && sj > 1e-8) ? covariance(i, j) / (si * sj) : (i == j ? 1.0 : 0.0);
+            corr(i, j) = c;
+            corr(j, i) = c;
+        }
+    }
+    return corr;
+}
+
+double RollingCovariance::average_correlation() {
+    if (n_ < 2 || filled_ < 2) return 0.0;
+
+    update_inverse_sd();
+    const std::vector<double>& inv_sd = inv_sd_;
+    const double w = static_cast<double>(filled_);
+    size_t valid = 0;
+    for (size_t i = 0; i < n_; ++i) {
+        if (inv_sd[i] > 0.0) ++valid;
+    }
+    if (valid < 2) return 0.0;
+
+    double total = 0.0;
+    for (size_t i = 0; i < n_; ++i) {
+        if (inv_sd[i] == 0.0) continue;
+        const double* row = &cross_[i * n_];
+        const double mi = sums_[i] / w;
+        double acc = 0.0;
+        for (size_t j = i + 1; j < n_; ++j) {
+            acc += (row[j] - mi * sums_[j]) * inv_sd[j];
+        }
+        total += acc * inv_sd[i];
+    }
+    total /= (w - 1);
+
+    return total / (valid * (valid - 1) / 2.0);
+}
+
+double RollingCovariance::top_eigenvalue_share(size_t max_iters, double tolerance) {
+    if (filled_ < 2) return 0.0;
+
+    update_inverse_sd();
+    size_t valid = 0;
+    for (size_t i = 0; i < n_; ++i) {
+        if (inv_sd_[i] > 0.0) ++valid;
+    }
+    if (valid == 0) return 0.0;
+
+    const double w = static_cast<double>(filled_);
+    std::vector<double>& v = eigvec_;
+    std::vector<double>& y = scratch_;
+
+    // A stale or degenerate warm start (e.g. an asset that just became
+    // valid) falls back to the uniform vector
+    double norm = 0.0;
+    for (size_t i = 0; i < n_; ++i) {
+        if (inv_sd_[i] == 0.0) v[i] = 0.0;
+        norm += v[i] * v[i];
+    }
+    if (norm < 1e-12) {
+        for (size_t i = 0; i < n_; ++i) {
+            v[i] = inv_sd_[i] > 0.0 ? 1.0 : 0.0;
+        }
+        norm = static_cast<double>(valid);
+    }
+    norm = std::sqrt(norm);
+    for (double& x : v) x /= norm;
+
+    double lambda = 0.0;
+    std::vector<double>& scaled = scaled_;
+    for (size_t iter = 0; iter < max_iters; ++iter) {
+        // y = D Cov D v with D = diag(1/sd), using the stored upper triangle
+        for (size_t i = 0; i < n_; ++i) {
+            scaled[i] = v[i] * inv_sd_[i];
+        }
+        std::fill(y.begin(), y.end(), 0.0);
+        for (size_t i = 0; i < n_; ++i) {
+            const double* row = &cross_[i * n_];
+            const double mi = sums_[i] / w;
+            const double si = scaled[i];
+            double acc = (row[i] - mi * sums_[i]) * si;
+            for (size_t j = i + 1; j < n_; ++j) {
+                double c = row[j] - mi * sums_[j];
+                acc += c * scaled[j];
+                y[j] += c * si;
+            }
+            y[i] += acc;
+        }
+
+        double next_lambda = 0.0;
+        double next_norm = 0.0;
+        for (size_t i = 0; i < n_; ++i) {
+            y[i] *= inv_sd_[i] / (w - 1);
+            next_lambda += v[i] * y[i];
+            next_norm += y[i] * y[i];
+        }
+        next_norm = std::sqrt(next_norm);
+        if (next_norm < 1e-300) break;
+
+        for (size_t i = 0; i < n_; ++i) {
+            v[i] = y[i] / next_norm;
+        }
+
+        bool converged = std::fabs(next_lambda - lambda) <= tolerance * std::fabs(next_lambda);
+        lambda = next_lambda;
+        if (converged) break;
+    }
+
+    return lambda / valid;
+}
+
+Matrix CrossAsset::regime_features(const std::vector<TimeSeries>& returns, size_t window) {
+    if (returns.empty()) throw std::invalid_argument("Need at least one asset");
+
+    const size_t n = returns.size();
+    const size_t T = returns.front().size();
+    for (const auto& r : returns) {
+        if (r.size() != T) throw std::invalid_argument("Return series must be aligned");
+    }
+    if (T < window) throw std::invalid_argument("Window size larger than series");
+
+    RollingCovariance cov(n, window);
+    Matrix features(T - window + 1, 2);
+    std::vector<double> bar(n);
+
+    size_t row = 0;
+    for (size_t t = 0; t < T; ++t) {
+        for (size_t i = 0; i < n; ++i) {
+            bar[i] = returns[i].values[t];
+        }
+        if (cov.push(bar.data())) {
+            features(row, 0) = cov.average_correlation();
+            features(row, 1) = cov.top_eigenvalue_share();
+            ++row;
+        }
+    }
+    return features;
+}
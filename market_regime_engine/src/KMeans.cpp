@@ -0,0 +1,229 @@
+#include "models/KMeans.hpp"
+#include <iostream>
+#include <random>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+template <typename T>
+double KMeans::squared_distance(const T* a, const double* b, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double diff = static_cast<double>(a[i]) - b[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+template <typename T>
+double KMeans::min_sq_distance(const T* row, size_t num_centroids) const {
+    double min_dist = std::numeric_limits<double>::max();
+    for (size_t c = 0; c < num_centroids; ++c) {
+        min_dist = std::min(min_dist, squared_distance(row, &centroids_.data[c * centroids_.cols],
+                                                       centroids_.cols));
+    }
+    return min_dist;
+}
+
+// Centroids as a cols x k array in the feature type, so the distance kernel's
+// inner loop runs across centroids
+template <typename T>
+std::vector<T> KMeans::transposed_centroids() const {
+    const size_t cols = centroids_.cols;
+    std::vector<T> centroids_t(cols * k_);
+    for (size_t c = 0; c < k_; ++c) {
+        for (size_t j = 0; j < cols; ++j) {
+            centroids_t[j * k_ + c] = static_cast<T>(centroids_.data[c * cols + j]);
+        }
+    }
+    return centroids_t;
+}
+
+// Distances to all k centroids at once: the loop over centroids is
+// independent and vectorizes, while each centroid's sum is still taken in
+// column order, so the double path is exact.
+template <typename T>
+size_t KMeans::nearest_centroid(const T* row, const T* centroids_t, T* dist,
+                                double& min_sq_dist) const {
+    const size_t cols = centroids_.cols;
+    std::fill(dist, dist + k_, T(0));
+    for (size_t j = 0; j < cols; ++j) {
+        const T x = row[j];
+        const T* cj = centroids_t + j * k_;
+        for (size_t c = 0; c < k_; ++c) {
+            T diff = x - cj[c];
+            dist[c] += diff * diff;
+        }
+    }
+
+    T best = std::numeric_limits<T>::max();
+    size_t best_cluster = 0;
+    for (size_t c = 0; c < k_; ++c) {
+        if (dist[c] < best) {
+            best = dist[c];
+            best_cluster = c;
+        }
+    }
+    min_sq_dist = static_cast<double>(best);
+    return best_cluster;
+}
+
+// k-means++ seeding in streaming form: one pass to total the D^2 weights and
+// a second to locate the sampled row, per centroid.
+template <typename T>
+void KMeans::initialize_centroids(BasicFeatureSource<T>& source) {
+    std::mt19937 gen(seed_);
+    const size_t cols = source.cols();
+    BasicMatrixView<T> block;
+
+    size_t rows = 0;
+    source.rewind();
+    while (source.next_block(block)) {
+        rows += block.rows;
+    }
+
+    if (rows < k_) {
+        throw std::invalid_argument("Number of samples must be >= k");
+    }
+
+    centroids_ = Matrix(k_, cols);
+
+    auto copy_row = [&](const T* row, size_t c) {
+        for (size_t j = 0; j < cols; ++j) {
+            centroids_(c, j) = row[j];
+        }
+    };
+
+    std::uniform_int_distribution<size_t> dis(0, rows - 1);
+    size_t first_idx = dis(gen);
+    size_t offset = 0;
+    source.rewind();
+    while (source.next_block(block)) {
+        if (first_idx < offset + block.rows) {
+            copy_row(block.row(first_idx - offset), 0);
+            break;
+        }
+        offset += block.rows;
+    }
+
+    for (size_t c = 1; c < k_; ++c) {
+        double sum = 0.0;
+        source.rewind();
+        while (source.next_block(block)) {
+            for (size_t i = 0; i < block.rows; ++i) {
+                sum += min_sq_distance(block.row(i), c);
+            }
+        }
+
+        std::uniform_real_distribution<> prob_dis(0.0, sum);
+        double target = prob_dis(gen);
+
+        double cumsum = 0.0;
+        bool chosen = false;
+        bool first_block = true;
+        source.rewind();
+        while (!chosen && source.next_block(block)) {
+            if (first_block) {
+                copy_row(block.row(0), c);
+                first_block = false;
+            }
+            for (size_t i = 0; i < block.rows; ++i) {
+                cumsum += min_sq_distance(block.row(i), c);
+                if (cumsum >= target) {
+                    copy_row(block.row(i), c);
+                    chosen = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+void KMeans::predict(const BasicMatrixView<T>& block, int* labels, double& inertia) const {
+    std::vector<T> centroids_t = transposed_centroids<T>();
+    std::vector<T> dists(k_);
+    for (size_t i = 0; i < block.rows; ++i) {
+        double dist;
+        labels[i] = static_cast<int>(nearest_centroid(block.row(i), centroids_t.data(), dists.data(), dist));
+        inertia += dist;
+    }
+}
+
+template <typename T>
+void KMeans::fit(BasicFeatureSource<T>& source) {
+    initialize_centroids(source);
+
+    const size_t cols = source.cols();
+    BasicMatrixView<T> block;
+
+    iterations_ = 0;
+    for (size_t iter = 0; iter < max_iters_; ++iter) {
+        ++iterations_;
+        Matrix new_centroids(k_, cols);
+        std::vector<size_t> counts(k_, 0);
+        double inertia = 0.0;
+        std::vector<T> centroids_t = transposed_centroids<T>();
+        std::vector<T> dists(k_);
+
+        source.rewind();
+        while (source.next_block(block)) {
+            for (size_t i = 0; i < block.rows; ++i) {
+                const T* row = block.row(i);
+                double dist;
+                size_t cluster = nearest_centroid(row, centroids_t.data(), dists.data(), dist);
+                counts[cluster]++;
+                inertia += dist;
+                for (size_t j = 0; j < cols; ++j) {
+                    new_centroids.data[cluster * cols + j] += row[j];
+                }
+            }
+        }
+        inertia_ = inertia;
+
+        for (size_t c = 0; c < k_; ++c) {
+            if (counts[c] > 0) {
+                for (size_t j = 0; j < cols; ++j) {
+                    new_centroids(c, j) /= counts[c];
+                }
+            }
+        }
+
+        double movement = 0.0;
+        for (size_t c = 0; c < k_; ++c) {
+            movement += std::sqrt(squared_distance(&centroids_.data[c * cols],
+                                                   &new_centroids.data[c * cols], cols));
+        }
+
+        centroids_ = new_centroids;
+
+        if (movement < tolerance_) {
+            if (verbose_) std::cout << "K-Means converged at iteration " << iter << std::endl;
+            return;
+        }
+    }
+
+    if (verbose_) std::cout << "K-Means reached max iterations" << std::endl;
+}
+
+template <typename T>
+std::vector<int> KMeans::fit_predict(const BasicMatrix<T>& X) {
+    if (X.rows < k_) {
+        throw std::invalid_argument("Number of samples must be >= k");
+    }
+
+    BasicMatrixSource<T> source(X);
+    fit(source);
+
+    std::vector<int> labels(X.rows);
+    inertia_ = 0.0;
+    predict(X.view(), labels.data(), inertia_);
+    return labels;
+}
+
+template std::vector<int> KMeans::fit_predict(const Matrix&);
+template std::vector<int> KMeans::fit_predict(const MatrixF&);
+template void KMeans::fit(FeatureSource&);
+template void KMeans::fit(BasicFeatureSource<float>&);
+template void KMeans::predict(const MatrixView&, int*, double&) const;
+template void KMeans::predict(const MatrixViewF&, int*, double&) const;
@@ -0,0 +1,206 @@
+#include "models/ModelSelection.hpp"
+#include "models/KMeans.hpp"
+#include "core/CounterRng.hpp"
+#include "core/ParallelFor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+static unsigned int fit_seed(const ModelSelection::Config& config, size_t s) {
+    return static_cast<unsigned int>(CounterRng::mix(config.seed + s));
+}
+
+// Index of (i, j), i < j, in a condensed upper-triangular distance array
+static size_t condensed_index(size_t i, size_t j, size_t m) {
+    return i * m - i * (i + 1) / 2 + (j - i - 1);
+}
+
+double ModelSelection::sampled_silhouette(const std::vector<double>& dist, const std::vector<int>& labels,
+                                          size_t k) {
+    const size_t m = labels.size();
+    std::vector<size_t> sizes(k, 0);
+    for (int l : labels) sizes[l]++;
+
+    // Per-point sums of distances to each cluster, accumulated in one sweep
+    // over the condensed matrix
+    std::vector<double> sums(m * k, 0.0);
+    for (size_t i = 0; i + 1 < m; ++i) {
+        const double* row = &dist[condensed_index(i, i + 1, m)];
+        double* si = &sums[i * k];
+        const int li = labels[i];
+        for (size_t j = i + 1; j < m; ++j) {
+            double d = row[j - i - 1];
+            si[labels[j]] += d;
+            sums[j * k + li] += d;
+        }
+    }
+
+    double total = 0.0;
+    for (size_t i = 0; i < m; ++i) {
+        const int li = labels[i];
+        if (sizes[li] < 2) continue;  // silhouette of a singleton is 0
+
+        double a = sums[i * k + li] / (sizes[li] - 1);
+        double b = std::numeric_limits<double>::max();
+        for (size_t c = 0; c < k; ++c) {
+            if (static_cast<int>(c) != li && sizes[c] > 0) {
+                b = std::min(b, sums[i * k + c] / sizes[c]);
+            }
+        }
+        if (b == std::numeric_limits<double>::max()) continue;
+        double denom = std::max(a, b);
+        if (denom > 0.0) total += (b - a) / denom;
+    }
+    return total / m;
+}
+
+double ModelSelection::adjusted_rand_index(const std::vector<int>& a, const std::vector<int>& b, size_t k) {
+    const size_t n = a.size();
+    if (n < 2) return 1.0;
+
+    std::vector<size_t> table(k * k, 0), rows(k, 0), cols(k, 0);
+    for (size_t i = 0; i < n; ++i) {
+        table[a[i] * k + b[i]]++;
+        rows[a[i]]++;
+        cols[b[i]]++;
+    }
+
+    auto pairs = [](size_t x) { return x * (x - 1) / 2.0; };
+    double index = 0.0, sum_rows = 0.0, sum_cols = 0.0;
+    for (size_t v : table) index += pairs(v);
+    for (size_t v : rows) sum_rows += pairs(v);
+    for (size_t v : cols) sum_cols += pairs(v);
+
+    double expected = sum_rows * sum_cols / pairs(n);
+    double max_index = (sum_rows + sum_cols) / 2.0;
+    if (max_index - expected == 0.0) return 1.0;
+    return (index - expected) / (max_index - expected);
+}
+
+template <typename T>
+ModelSelection::Result ModelSelection::select_k(const BasicMatrix<T>& X, const Config& config) {
+    if (config.min_k < 2 || config.max_k < config.min_k) {
+        throw std::invalid_argument("Need 2 <= min_k <= max_k");
+    }
+    if (config.seeds == 0 || config.silhouette_sample < 2) {
+        throw std::invalid_argument("Need at least one seed and a silhouette sample of 2 or more");
+    }
+    if (X.rows < config.max_k) {
+        throw std::invalid_argument("Number of samples must be >= max_k");
+    }
+
+    // Fixed row sample (partial Fisher-Yates) shared by every fit
+    const size_t m = std::min(config.silhouette_sample, X.rows);
+    std::vector<size_t> sample(X.rows);
+    std::iota(sample.begin(), sample.end(), 0);
+    CounterRng rng(config.seed, 0);
+    for (size_t i = 0; i < m; ++i) {
+        size_t j = i + rng.uniform_index(static_cast<uint32_t>(X.rows - i));
+        std::swap(sample[i], sample[j]);
+    }
+    sample.resize(m);
+    std::sort(sample.begin(), sample.end());
+
+    // Pairwise sample distances, computed once
+    std::vector<double> dist(m * (m - 1) / 2);
+    parallel_for(m, config.num_threads, [&](size_t i) {
+        const T* xi = &X.data[sample[i] * X.cols];
+        for (size_t j = i + 1; j < m; ++j) {
+            const T* xj = &X.data[sample[j] * X.cols];
+            double sum = 0.0;
+            for (size_t c = 0; c < X.cols; ++c) {
+                double diff = static_cast<double>(xi[c]) - xj[c];
+                sum += diff * diff;
+            }
+            dist[condensed_index(i, j, m)] = std::sqrt(sum);
+        }
+    });
+
+    const size_t num_k = config.max_k - config.min_k + 1;
+    const size_t num_fits = num_k * config.seeds;
+    std::vector<double> inertia(num_fits);
+    std::vector<std::vector<int>> sample_labels(num_fits);
+
+    parallel_for(num_fits, config.num_threads, [&](size_t task) {
+        size_t k = config.min_k + task / config.seeds;
+        size_t s = task % config.seeds;
+
+        KMeans km(k, config.max_iters, config.tolerance, fit_seed(config, s));
+        km.set_verbose(false);
+        auto labels = km.fit_predict(X);
+
+        inertia[task] = km.get_inertia();
+        sample_labels[task].resize(m);
+        for (size_t i = 0; i < m; ++i) {
+            sample_labels[task][i] = labels[sample[i]];
+        }
+    });
+
+    Result result;
+    result.scores.resize(num_k);
+
+    parallel_for(num_k, config.num_threads, [&](size_t ki) {
+        Score& score = result.scores[ki];
+        score.k = config.min_k + ki;
+        size_t base = ki * config.seeds;
+
+        size_t best = base;
+        for (size_t s = 1; s < config.seeds; ++s) {
+            if (inertia[base + s] < inertia[best]) best = base + s;
+        }
+        score.inertia = inertia[best];
+        score.seed = fit_seed(config, best - base);
+        score.silhouette = sampled_silhouette(dist, sample_labels[best], score.k);
+
+        if (config.seeds > 1) {
+            double ari = 0.0;
+            size_t pairs = 0;
+            for (size_t a = 0; a < config.seeds; ++a) {
+                for (size_t b = a + 1; b < config.seeds; ++b) {
+                    ari += adjusted_rand_index(sample_labels[base + a], sample_labels[base + b], score.k);
+                    ++pairs;
+                }
+            }
+            score.stability = ari / pairs;
+        }
+    });
+
+    // Elbow: the k furthest below the chord joining the normalized inertia
+    // curve's end points
+    result.elbow_k = config.min_k;
+    if (num_k > 2) {
+        double first = result.scores.front().inertia;
+        double last = result.scores.back().inertia;
+        double range = first - last;
+        double best_gap = -1.0;
+        for (size_t ki = 0; ki < num_k && range > 0.0; ++ki) {
+            double x = static_cast<double>(ki) / (num_k - 1);
+            double y = (result.scores[ki].inertia - last) / range;
+            double gap = (1.0 - x) - y;
+            if (gap > best_gap) {
+                best_gap = gap;
+                result.elbow_k = result.scores[ki].k;
+            }
+        }
+    }
+
+    // Best silhouette among stable fits; fall back to all fits
+    double best_silhouette = -std::numeric_limits<double>::max();
+    for (int pass = 0; pass < 2 && result.best_k == 0; ++pass) {
+        for (const auto& score : result.scores) {
+            if (pass == 0 && score.stability < config.min_stability) continue;
+            if (score.silhouette > best_silhouette) {
+                best_silhouette = score.silhouette;
+                result.best_k = score.k;
+                result.best_seed = score.seed;
+            }
+        }
+    }
+
+    return result;
+}
+
+template ModelSelection::Result ModelSelection::select_k(const Matrix&, const Config&);
+template ModelSelection::Result ModelSelection::select_k(const MatrixF&, const Config&);
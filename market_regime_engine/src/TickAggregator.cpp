@@ -0,0 +1,303 @@
+#include "data/TickAggregator.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+
+static const int64_t MS_PER_DAY = 86400000LL;
+
+// Days since 1970-01-01 for a proleptic Gregorian date
+static int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+static void civil_from_days(int64_t z, int& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int>(yoe + era * 400 + (m <= 2));
+}
+
+static int64_t parse_timestamp(const char* s, const char* end) {
+    bool iso = false;
+    for (const char* p = s; p < end; ++p) {
+        if (*p == '-' && p != s) {
+            iso = true;
+            break;
+        }
+    }
+
+    if (!iso) {
+        return std::strtoll(s, nullptr, 10);
+    }
+
+    // Scan a bounded copy of the field so a date-only value can't pick up the
+    // next column as its hour; a missing time part is midnight
+    char field[64];
+    size_t len = static_cast<size_t>(end - s);
+    if (len >= sizeof(field)) {
+        throw std::runtime_error("Bad timestamp: " + std::string(s, end));
+    }
+    std::memcpy(field, s, len);
+    field[len] = '\0';
+
+    int y = 0, mo = 0, d = 0, h = 0, mi = 0;
+    double sec = 0.0;
+    if (std::sscanf(field, "%d-%d-%d%*c%d:%d:%lf", &y, &mo, &d, &h, &mi, &sec) < 3) {
+        throw std::runtime_error("Bad timestamp: " + std::string(s, end));
+    }
+    return days_from_civil(y, mo, d) * MS_PER_DAY + (h * 3600LL + mi * 60LL) * 1000 +
+           static_cast<int64_t>(sec * 1000.0 + 0.5);
+}
+
+TradeReader::TradeReader(const std::string& path) : path_(path), buffer_(1 << 20) {
+    file_.rdbuf()->pubsetbuf(buffer_.data(), buffer_.size());
+    file_.open(path, std::ios::binary);
+    if (!file_.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+
+    if (!std::getline(file_, line_)) {
+        throw std::runtime_error("Empty file: " + path);
+    }
+    if (!line_.empty() && line_.back() == '\r') line_.pop_back();
+
+    int idx = 0;
+    size_t start = 0;
+    for (;;) {
+        size_t comma = line_.find(',', start);
+        std::string h = line_.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        h.erase(std::remove(h.begin(), h.end(), '"'), h.end());
+        for (auto& ch : h) ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+
+        if (h == "timestamp" || h == "time" || h == "ts") ts_idx_ = idx;
+        else if (h == "price") price_idx_ = idx;
+        else if (h == "size" || h == "volume" || h == "qty" || h == "quantity") size_idx_ = idx;
+
+        if (comma == std::string::npos) break;
+        start = comma + 1;
+        ++idx;
+    }
+
+    if (ts_idx_ < 0 || price_idx_ < 0) {
+        throw std::runtime_error("Trade file needs timestamp and price columns: " + path);
+    }
+}
+
+bool TradeReader::next(Trade& trade) {
+    while (std::getline(file_, line_)) {
+        ++line_no_;
+        if (!line_.empty() && line_.back() == '\r') line_.pop_back();
+        if (line_.empty()) continue;
+
+        const char* fields[16] = {};
+        const char* ends[16] = {};
+        int n = 0;
+        const char* p = line_.c_str();
+        const char* end = p + line_.size();
+        while (n < 16) {
+            const char* comma = static_cast<const char*>(std::memchr(p, ',', end - p));
+            fields[n] = p;
+            ends[n] = comma ? comma : end;
+            ++n;
+            if (!comma) break;
+            p = comma + 1;
+        }
+
+        if (ts_idx_ >= n || price_idx_ >= n) {
+            throw std::runtime_error("Malformed trade at " + path_ + ":" + std::to_string(line_no_));
+        }
+
+        trade.timestamp_ms = parse_timestamp(fields[ts_idx_], ends[ts_idx_]);
+        trade.price = std::strtod(fields[price_idx_], nullptr);
+        trade.size = (size_idx_ >= 0 && size_idx_ < n) ? std::strtod(fields[size_idx_], nullptr) : 0.0;
+
+        if (trade.timestamp_ms < last_ts_) {
+            throw std::runtime_error("Trades out of time order at " + path_ + ":" +
+                                     std::to_string(line_no_));
+        }
+        last_ts_ = trade.timestamp_ms;
+        return true;
+    }
+    return false;
+}
+
+int64_t TickAggregator::parse_interval(const std::string& spec) {
+    if (spec.empty()) throw std::invalid_argument("Empty bar interval");
+
+    size_t pos = 0;
+    long long count = std::stoll(spec, &pos);
+    std::string unit = spec.substr(pos);
+    if (count <= 0) throw std::invalid_argument("Bar interval must be positive: " + spec);
+
+    if (unit == "s") return count * 1000LL;
+    if (unit == "m") return count * 60000LL;
+    if (unit == "h") return count * 3600000LL;
+    if (unit == "d") return count * MS_PER_DAY;
+    throw std::invalid_argument("Unknown bar interval unit: " + spec);
+}
+
+std::string TickAggregator::format_timestamp(int64_t ms, int64_t interval_ms) {
+    int64_t days = ms >= 0 ? ms / MS_PER_DAY : -((-ms + MS_PER_DAY - 1) / MS_PER_DAY);
+    int64_t ms_of_day = ms - days * MS_PER_DAY;
+    int y;
+    unsigned m, d;
+    civil_from_days(days, y, m, d);
+
+    char buf[64];
+    if (interval_ms % MS_PER_DAY == 0) {
+        std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u", y, m, d);
+    } else if (interval_ms % 60000 == 0) {
+        std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u %02d:%02d", y, m, d,
+                      static_cast<int>(ms_of_day / 3600000), static_cast<int>(ms_of_day / 60000 % 60));
+    } else {
+        std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u %02d:%02d:%02d", y, m, d,
+                      static_cast<int>(ms_of_day / 3600000), static_cast<int>(ms_of_day / 60000 % 60),
+                      static_cast<int>(ms_of_day / 1000 % 60));
+    }
+    return buf;
+}
+
+size_t TickAggregator::merge(const std::vector<std::string>& paths, int64_t interval_ms,
+                             const std::function<void(const Bar&)>& on_bar) {
+    if (interval_ms <= 0) throw std::invalid_argument("Bar interval must be positive");
+
+    struct HeapEntry {
+        Trade trade;
+        size_t source;
+        bool operator>(const HeapEntry& other) const {
+            if (trade.timestamp_ms != other.trade.timestamp_ms) {
+                return trade.timestamp_ms > other.trade.timestamp_ms;
+            }
+            return source > other.source;
+        }
+    };
+
+    std::vector<std::unique_ptr<TradeReader>> readers;
+    for (const auto& path : paths) {
+        readers.push_back(std::make_unique<TradeReader>(path));
+    }
+
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+    for (size_t s = 0; s < readers.size(); ++s) {
+        Trade t;
+        if (readers[s]->next(t)) heap.push({t, s});
+    }
+
+    Bar bar;
+    bool open = false;
+    size_t trades = 0;
+
+    while (!heap.empty()) {
+        HeapEntry top = heap.top();
+        heap.pop();
+
+        const Trade& t = top.trade;
+        int64_t floor_ms = t.timestamp_ms - ((t.timestamp_ms % interval_ms) + interval_ms) % interval_ms;
+
+        if (!open || floor_ms != bar.start_ms) {
+            if (open) on_bar(bar);
+            bar = Bar();
+            bar.start_ms = floor_ms;
+            bar.open = bar.high = bar.low = t.price;
+            open = true;
+        }
+
+        bar.high = std::max(bar.high, t.price);
+        bar.low = std::min(bar.low, t.price);
+        bar.close = t.price;
+        bar.volume += t.size;
+        bar.trades++;
+        trades++;
+
+        Trade next;
+        if (readers[top.source]->next(next)) heap.push({next, top.source});
+    }
+
+    if (open) on_bar(bar);
+    return trades;
+}
+
+TickAggregator::Bars TickAggregator::aggregate(const std::vector<std::string>& paths,
+                                               int64_t interval_ms) {
+    Bars bars;
+    auto append = [&](TimeSeries& series, double value, const std::string& date) {
+        series.values.push_back(value);
+        series.dates.push_back(date);
+    };
+
+    bars.trades = merge(paths, interval_ms, [&](const Bar& bar) {
+        std::string date = format_timestamp(bar.start_ms, interval_ms);
+        append(bars.open, bar.open, date);
+        append(bars.high, bar.high, date);
+        append(bars.low, bar.low, date);
+        append(bars.close, bar.close, date);
+        append(bars.volume, bar.volume, date);
+    });
+    return bars;
+}
+
+void TickAggregator::write_csv(const Bars& bars, const std::string& path) {
+    BarCsvWriter writer(path, MS_PER_DAY);
+    for (size_t i = 0; i < bars.close.size(); ++i) {
+        writer.write(bars.close.dates[i], bars.open.values[i], bars.high.values[i],
+                     bars.low.values[i], bars.close.values[i], bars.volume.values[i]);
+    }
+    writer.close();
+}
+
+BarCsvWriter::BarCsvWriter(const std::string& path, int64_t interval_ms)
+    : path_(path), interval_ms_(interval_ms) {
+    out_ = std::fopen(path.c_str(), "w");
+    if (!out_) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    std::fprintf(out_, "Date,Open,High,Low,Close,Volume\n");
+}
+
+BarCsvWriter::~BarCsvWriter() {
+    if (out_) std::fclose(out_);
+}
+
+void BarCsvWriter::write(const Bar& bar) {
+    write(TickAggregator::format_timestamp(bar.start_ms, interval_ms_), bar.open, bar.high, bar.low,
+          bar.close, bar.volume);
+}
+
+void BarCsvWriter::write(const std::string& date, double open, double high, double low, double close,
+                         double volume) {
+    std::fprintf(out_, "%s,%.10g,%.10g,%.10g,%.10g,%.10g\n", date.c_str(), open, high, low, close, volume);
+    ++bars_;
+}
+
+void BarCsvWriter::close() {
+    if (!out_) return;
+    bool failed = std::ferror(out_) != 0;
+    failed = std::fclose(out_) != 0 || failed;
+    out_ = nullptr;
+    if (failed) {
+        throw std::runtime_error("Error writing file: " + path_);
+    }
+}
+
+void BarCsvWriter::discard() {
+    if (out_) {
+        std::fclose(out_);
+        out_ = nullptr;
+    }
+    std::remove(path_.c_str());
+}
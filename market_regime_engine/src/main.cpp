@@ -1,39 +1,48 @@
 #include "data/CSVReader.hpp"
-#include "features/Returns.hpp"
-#include "features/Volatility.hpp"
-#include "features/Drawdown.hpp"
+#include "data/TickAggregator.hpp"
+#include "features/RegimeFeatures.hpp"
 #include "models/KMeans.hpp"
+#include "models/RegimeIndex.hpp"
+#include "models/ModelSelection.hpp"
+#include "core/CounterRng.hpp"
 #include "strategies/BuyHold.hpp"
 #include "strategies/Momentum.hpp"
 #include "strategies/MeanReversion.hpp"
 #include "backtest/Backtester.hpp"
 #include "backtest/Metrics.hpp"
+#include "backtest/Bootstrap.hpp"
+#include "pipeline/ChunkedPipeline.hpp"
+#include "server/AnalysisServer.hpp"
 
 #include <iostream>
 #include <iomanip>
-
-void print_regime_stats(const std::vector<int>& regimes, size_t num_regimes) {
-    std::vector<int> counts(num_regimes, 0);
-    for (int r : regimes) {
-        counts[r]++;
-    }
-
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <string>
+
+void print_regime_counts(const std::vector<size_t>& counts, size_t total) {
     std::cout << "\n=== Regime Statistics ===" << std::endl;
-    for (size_t i = 0; i < num_regimes; ++i) {
-        double pct = 100.0 * counts[i] / regimes.size();
+    for (size_t i = 0; i < counts.size(); ++i) {
+        double pct = 100.0 * counts[i] / total;
         std::cout << "Regime " << i << ": " << counts[i] 
                   << " periods (" << std::fixed << std::setprecision(1) 
                   << pct << "%)" << std::endl;
     }
 }
 
-void print_strategy_performance(const std::string& name, 
-                               const Backtester::BacktestResult& result) {
-    double sharpe = Metrics::sharpe(result.returns);
-    double max_dd = Metrics::max_drawdown(result.equity_curve);
-    double total_ret = Metrics::total_return(result.equity_curve);
-    double annual_ret = Metrics::annual_return(result.returns);
+void print_regime_stats(const RegimeIndex& index) {
+    std::vector<size_t> counts(index.num_regimes());
+    for (size_t r = 0; r < counts.size(); ++r) {
+        counts[r] = index.duration(static_cast<int>(r));
+    }
+    print_regime_counts(counts, index.size());
+}
 
+void print_metrics(const std::string& name, double total_ret, double annual_ret,
+                   double sharpe, double max_dd) {
     std::cout << "\n" << name << ":" << std::endl;
     std::cout << "  Total Return: " << std::fixed << std::setprecision(2) 
               << total_ret * 100 << "%" << std::endl;
@@ -43,37 +52,131 @@ void print_strategy_performance(const std::string& name,
               << max_dd * 100 << "%" << std::endl;
 }
 
-void print_regime_performance(Strategy& strat, const TimeSeries& prices,
-                             const std::vector<int>& regimes, size_t num_regimes) {
-    auto full_result = Backtester::run(prices, strat);
-    
-    std::cout << "\n=== " << strat.name() << " by Regime ===" << std::endl;
-    
-    for (size_t regime = 0; regime < num_regimes; ++regime) {
-        TimeSeries regime_returns;
-        
-        for (size_t i = 0; i < regimes.size() && i < full_result.returns.size(); ++i) {
-            if (regimes[i] == static_cast<int>(regime)) {
-                regime_returns.values.push_back(full_result.returns[i]);
+void print_strategy_performance(const std::string& name, 
+                               const Backtester::BacktestResult& result) {
+    print_metrics(name,
+                  Metrics::total_return(result.equity_curve),
+                  Metrics::annual_return(result.returns),
+                  Metrics::sharpe(result.returns),
+                  Metrics::max_drawdown(result.equity_curve));
+}
+
+void print_regime_line(size_t regime, double regime_annual, double regime_sharpe) {
+    std::cout << "  Regime " << regime << ": " 
+              << "Ann. Return = " << std::fixed << std::setprecision(2)
+              << regime_annual * 100 << "%, Sharpe = " 
+              << std::setprecision(3) << regime_sharpe << std::endl;
+}
+
+void print_regime_performance(const std::string& name,
+                             const Backtester::BacktestResult& result,
+                             const RegimeIndex& index) {
+    std::cout << "\n=== " << name << " by Regime ===" << std::endl;
+
+    // One time-ordered pass over the returns, span by span
+    std::vector<ReturnAccumulator> by_regime(index.num_regimes());
+    index.for_each_span(result.returns.values, [&](int regime, const double* values, size_t n) {
+        ReturnAccumulator& acc = by_regime[regime];
+        for (size_t i = 0; i < n; ++i) {
+            acc.add(values[i]);
+        }
+    });
+
+    for (size_t regime = 0; regime < by_regime.size(); ++regime) {
+        if (by_regime[regime].count() > 0) {
+            print_regime_line(regime, by_regime[regime].annual_return(), by_regime[regime].sharpe());
+        }
+    }
+}
+
+void print_regime_confidence(const std::string& name, const TimeSeries& returns,
+                             const RegimeIndex& index, const Bootstrap::Config& config) {
+    auto start = std::chrono::steady_clock::now();
+    auto intervals = Bootstrap::regime_intervals(returns, index, config);
+    auto elapsed = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "\n=== " << name << " Regime Confidence Intervals ("
+              << std::fixed << std::setprecision(0) << config.confidence * 100 << "%, "
+              << config.replicates << " replicates, " << std::setprecision(1)
+              << elapsed << " ms) ===" << std::endl;
+
+    for (const auto& ci : intervals) {
+        if (ci.observations < 2) continue;
+        std::cout << "  Regime " << ci.regime << " (" << ci.observations << " days): "
+                  << "Ann. Return = " << std::setprecision(2) << ci.annual_return.estimate * 100
+                  << "% [" << ci.annual_return.lower * 100 << ", " << ci.annual_return.upper * 100
+                  << "], Sharpe = " << std::setprecision(3) << ci.sharpe.estimate
+                  << " [" << ci.sharpe.lower << ", " << ci.sharpe.upper << "]" << std::endl;
+    }
+}
+
+// Per-regime statistics behind the attribution report, from the in-memory
+// regime index and features or from the chunked pipeline's streamed totals
+struct RegimeSummary {
+    size_t days = 0;
+    std::vector<size_t> durations;
+    std::vector<size_t> episodes;
+    std::vector<double> avg_vol;
+    std::vector<double> avg_dd;
+    std::vector<double> avg_corr;  // empty without cross-asset features
+    std::vector<std::vector<size_t>> transitions;
+};
+
+template <typename T>
+RegimeSummary summarize_regimes(const RegimeIndex& index, const BasicMatrix<T>& X) {
+    const size_t num_regimes = index.num_regimes();
+    const bool has_corr = X.cols > 2;
+
+    RegimeSummary summary;
+    summary.days = index.size();
+    summary.avg_vol.assign(num_regimes, 0.0);
+    summary.avg_dd.assign(num_regimes, 0.0);
+    if (has_corr) {
+        summary.avg_corr.assign(num_regimes, 0.0);
+    }
+
+    for (const auto& span : index.spans()) {
+        for (size_t i = span.start; i < span.start + span.length; ++i) {
+            summary.avg_vol[span.regime] += X(i, 0);  // volatility
+            summary.avg_dd[span.regime] += X(i, 1);   // drawdown
+            if (has_corr) {
+                summary.avg_corr[span.regime] += X(i, 2);  // average pairwise correlation
             }
         }
+    }
 
-        if (regime_returns.size() > 0) {
-            double regime_sharpe = Metrics::sharpe(regime_returns);
-            double regime_annual = Metrics::annual_return(regime_returns);
-            
-            std::cout << "  Regime " << regime << ": " 
-                      << "Ann. Return = " << std::fixed << std::setprecision(2)
-                      << regime_annual * 100 << "%, Sharpe = " 
-                      << std::setprecision(3) << regime_sharpe << std::endl;
+    for (size_t r = 0; r < num_regimes; ++r) {
+        size_t count = index.duration(static_cast<int>(r));
+        summary.durations.push_back(count);
+        summary.episodes.push_back(index.spans_of(static_cast<int>(r)).size());
+        if (count > 0) {
+            summary.avg_vol[r] /= count;
+            summary.avg_dd[r] /= count;
+            if (has_corr) summary.avg_corr[r] /= count;
+        }
+
+        summary.transitions.emplace_back(num_regimes);
+        for (size_t j = 0; j < num_regimes; ++j) {
+            summary.transitions[r][j] = index.transitions(static_cast<int>(r), static_cast<int>(j));
         }
     }
+    return summary;
+}
+
+RegimeSummary summarize_regimes(const ChunkedPipeline::Result& result) {
+    RegimeSummary summary;
+    summary.days = result.feature_rows;
+    summary.durations = result.regime_counts;
+    summary.episodes = result.regime_episodes;
+    summary.avg_vol = result.regime_avg_vol;
+    summary.avg_dd = result.regime_avg_dd;
+    summary.transitions = result.transitions;
+    return summary;
 }
 
-void generate_regime_report(const TimeSeries& prices,
-                           const std::vector<int>& regimes,
-                           size_t num_regimes,
-                           const Matrix& X) {
+void generate_regime_report(const RegimeSummary& summary) {
+    const size_t num_regimes = summary.durations.size();
     
     std::cout << "\n";
     std::cout << "========================================================================\n";
@@ -83,38 +186,34 @@ void generate_regime_report(const TimeSeries& prices,
     // 1. REGIME TIMELINE SUMMARY
     std::cout << "📊 REGIME TIMELINE SUMMARY\n";
     std::cout << "------------------------------------------------------------------------\n";
-    std::cout << "Total trading days analyzed: " << regimes.size() << "\n";
+    std::cout << "Total trading days analyzed: " << summary.days << "\n";
     std::cout << "Number of regimes detected: " << num_regimes << "\n\n";
 
-    std::vector<int> counts(num_regimes, 0);
-    std::vector<double> avg_vol(num_regimes, 0.0);
-    std::vector<double> avg_dd(num_regimes, 0.0);
-
-    for (size_t i = 0; i < regimes.size(); ++i) {
-        int regime = regimes[i];
-        counts[regime]++;
-        avg_vol[regime] += X(i, 0);  // volatility
-        avg_dd[regime] += X(i, 1);   // drawdown
-    }
-
     std::cout << "Regime Characteristics:\n";
     for (size_t i = 0; i < num_regimes; ++i) {
-        double pct = 100.0 * counts[i] / regimes.size();
-        avg_vol[i] /= counts[i];
-        avg_dd[i] /= counts[i];
+        size_t count = summary.durations[i];
+        double pct = 100.0 * count / summary.days;
         
         std::string regime_type;
-        if (avg_vol[i] < 0.15) regime_type = "LOW VOLATILITY";
-        else if (avg_vol[i] < 0.25) regime_type = "NORMAL";
+        if (summary.avg_vol[i] < 0.15) regime_type = "LOW VOLATILITY";
+        else if (summary.avg_vol[i] < 0.25) regime_type = "NORMAL";
         else regime_type = "HIGH VOLATILITY/CRISIS";
 
         std::cout << "\n  Regime " << i << " [" << regime_type << "]:\n";
-        std::cout << "    Duration: " << counts[i] << " days (" 
+        std::cout << "    Duration: " << count << " days (" 
                   << std::fixed << std::setprecision(1) << pct << "% of sample)\n";
         std::cout << "    Avg Volatility: " << std::setprecision(2) 
-                  << avg_vol[i] * 100 << "%\n";
+                  << summary.avg_vol[i] * 100 << "%\n";
         std::cout << "    Avg Drawdown: " << std::setprecision(2) 
-                  << avg_dd[i] * 100 << "%\n";
+                  << summary.avg_dd[i] * 100 << "%\n";
+        if (!summary.avg_corr.empty()) {
+            std::cout << "    Avg Correlation: " << std::setprecision(3)
+                      << summary.avg_corr[i] << "\n";
+        }
+        std::cout << "    Episodes: " << summary.episodes[i]
+                  << " (avg " << std::setprecision(1)
+                  << static_cast<double>(count) / std::max<size_t>(1, summary.episodes[i])
+                  << " days)\n";
     }
 
     // 2. REGIME TRANSITION MATRIX
@@ -122,12 +221,6 @@ void generate_regime_report(const TimeSeries& prices,
     std::cout << "------------------------------------------------------------------------\n";
     std::cout << "Probability of switching from one regime to another:\n\n";
 
-    // Calculate transition counts
-    std::vector<std::vector<int>> transitions(num_regimes, std::vector<int>(num_regimes, 0));
-    for (size_t i = 1; i < regimes.size(); ++i) {
-        transitions[regimes[i-1]][regimes[i]]++;
-    }
-
     // Print header
     std::cout << "       ";
     for (size_t j = 0; j < num_regimes; ++j) {
@@ -138,13 +231,14 @@ void generate_regime_report(const TimeSeries& prices,
     // Print matrix
     for (size_t i = 0; i < num_regimes; ++i) {
         std::cout << "Reg " << i << "  ";
-        int row_total = 0;
+        size_t row_total = 0;
         for (size_t j = 0; j < num_regimes; ++j) {
-            row_total += transitions[i][j];
+            row_total += summary.transitions[i][j];
         }
         
         for (size_t j = 0; j < num_regimes; ++j) {
-            double prob = (row_total > 0) ? (100.0 * transitions[i][j] / row_total) : 0.0;
+            size_t count = summary.transitions[i][j];
+            double prob = (row_total > 0) ? (100.0 * count / row_total) : 0.0;
             std::cout << std::setw(7) << std::fixed << std::setprecision(1) 
                       << prob << "%  ";
         }
@@ -166,38 +260,376 @@ void generate_regime_report(const TimeSeries& prices,
     std::cout << "\n========================================================================\n\n";
 }
 
+// Returns the selected k and sets kmeans_seed to the seed of its best-scoring
+// fit. Selection fits X in its own precision, so the caller's refit on X
+// reproduces the scored model exactly.
+template <typename T>
+size_t select_num_regimes(const BasicMatrix<T>& X, unsigned int seed, unsigned int& kmeans_seed) {
+    std::cout << "\nSelecting number of regimes..." << std::endl;
+
+    ModelSelection::Config config;
+    config.seed = seed;
+
+    auto start = std::chrono::steady_clock::now();
+    auto selection = ModelSelection::select_k(X, config);
+    auto elapsed = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    // Formatted locally so the fixed precision doesn't leak into later output
+    std::ostringstream table;
+    table << "   k    Inertia  Silhouette  Stability\n";
+    for (const auto& score : selection.scores) {
+        table << std::setw(4) << score.k
+              << std::setw(11) << std::fixed << std::setprecision(4) << score.inertia
+              << std::setw(12) << std::setprecision(3) << score.silhouette
+              << std::setw(11) << score.stability << "\n";
+    }
+    table << "Elbow at k = " << selection.elbow_k << ", selected k = " << selection.best_k
+          << " (" << std::setprecision(1) << elapsed << " ms)";
+    std::cout << table.str() << std::endl;
+    kmeans_seed = selection.best_seed;
+    return selection.best_k;
+}
+
+// Fits K-Means on features stored as T (choosing k first with --regimes auto)
+// and prints the regime statistics and report
+template <typename T>
+RegimeIndex detect_regimes(const BasicMatrix<T>& X, size_t num_regimes, bool auto_regimes,
+                           unsigned int seed) {
+    unsigned int kmeans_seed = seed;
+    if (auto_regimes) {
+        num_regimes = select_num_regimes(X, seed, kmeans_seed);
+    }
+
+    std::cout << "\nDetecting market regimes..." << std::endl;
+    KMeans km(num_regimes, 100, 1e-4, kmeans_seed);
+    auto regimes = km.fit_predict(X);
+
+    std::cout << "Regimes detected with inertia: " << km.get_inertia() << std::endl;
+    RegimeIndex regime_index(regimes, num_regimes);
+    print_regime_stats(regime_index);
+
+    generate_regime_report(summarize_regimes(regime_index, X));
+    return regime_index;
+}
+
+// Fits the same synthetic Gaussian-mixture features stored as double and as
+// float, and compares footprint, per-pass throughput and the labels.
+template <typename T>
+static double time_kmeans(const BasicMatrix<T>& X, size_t k, unsigned int seed,
+                          std::vector<int>& labels, KMeans& km) {
+    km = KMeans(k, 20, 1e-4, seed);
+    km.set_verbose(false);
+    auto start = std::chrono::steady_clock::now();
+    labels = km.fit_predict(X);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int run_kmeans_benchmark(size_t rows, unsigned int seed) {
+    const size_t cols = 16;
+    const size_t k = 8;
+
+    std::cout << "\nGenerating " << rows << " x " << cols << " features from " << k
+              << " Gaussian clusters..." << std::endl;
+    CounterRng rng(seed, 0);
+    Matrix centers(k, cols);
+    for (double& v : centers.data) {
+        v = 4.0 * rng.uniform() - 2.0;
+    }
+    Matrix X(rows, cols);
+    for (size_t i = 0; i < rows; ++i) {
+        size_t c = rng.uniform_index(static_cast<uint32_t>(k));
+        for (size_t j = 0; j < cols; ++j) {
+            double u1 = 1.0 - rng.uniform();
+            double u2 = rng.uniform();
+            double z = std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+            X(i, j) = centers(c, j) + 0.5 * z;
+        }
+    }
+    MatrixF Xf(X);
+
+    KMeans km_d(k), km_f(k);
+    std::vector<int> labels_d, labels_f;
+    double ms_d = time_kmeans(X, k, seed, labels_d, km_d);
+    double ms_f = time_kmeans(Xf, k, seed, labels_f, km_f);
+
+    auto report = [&](const char* name, size_t bytes, double ms, const KMeans& km) {
+        double passes = static_cast<double>(km.get_iterations()) + 1.0;  // + final labelling pass
+        std::cout << std::left << std::setw(8) << name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(10) << bytes / (1024.0 * 1024.0) << " MiB"
+                  << std::setw(10) << ms << " ms" << std::setw(6) << km.get_iterations() << " iters"
+                  << std::setw(10) << rows * passes / (ms * 1000.0) << " M rows/s"
+                  << "  inertia " << std::setprecision(4) << km.get_inertia() << std::endl;
+    };
+
+    std::cout << "\n=== K-Means Storage Precision (k = " << k << ") ===" << std::endl;
+    report("double", X.data.size() * sizeof(double), ms_d, km_d);
+    report("float", Xf.data.size() * sizeof(float), ms_f, km_f);
+
+    size_t same = 0;
+    for (size_t i = 0; i < rows; ++i) {
+        if (labels_d[i] == labels_f[i]) ++same;
+    }
+    std::cout << "Label agreement: " << std::setprecision(4) << 100.0 * same / rows
+              << "% identical, adjusted Rand index "
+              << std::setprecision(6) << ModelSelection::adjusted_rand_index(labels_d, labels_f, k)
+              << ", speedup " << std::setprecision(2) << ms_d / ms_f << "x" << std::endl;
+    return 0;
+}
+
+// Parameter sweep over the strategy families. Each run streams into a
+// MetricsSink, so no per-run series are allocated.
+int run_sweep(const TimeSeries& prices) {
+    struct Candidate {
+        std::string label;
+        std::unique_ptr<Strategy> strategy;
+        MetricsSink metrics;
+    };
+
+    std::vector<Candidate> candidates;
+    for (size_t lookback = 5; lookback <= 250; lookback += 5) {
+        candidates.push_back({"Momentum(" + std::to_string(lookback) + ")",
+                              std::make_unique<Momentum>(lookback), MetricsSink()});
+    }
+    for (size_t window = 10; window <= 100; window += 10) {
+        for (double threshold : {1.0, 1.5, 2.0}) {
+            std::ostringstream label;
+            label << "MeanReversion(" << window << ", " << std::fixed << std::setprecision(1)
+                  << threshold << ")";
+            candidates.push_back({label.str(), std::make_unique<MeanReversion>(window, threshold),
+                                  MetricsSink()});
+        }
+    }
+
+    // Strategies whose warmup exceeds the history have no result to rank
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                    [&](const Candidate& c) { return c.strategy->warmup() > prices.size(); }),
+                     candidates.end());
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto& c : candidates) {
+        Backtester::run(prices, *c.strategy, c.metrics);
+    }
+    const size_t runs = candidates.size();
+    auto elapsed = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.metrics.sharpe() > b.metrics.sharpe();
+    });
+
+    std::cout << "\n=== Parameter Sweep (" << runs << " backtests, " << std::fixed
+              << std::setprecision(1) << elapsed << " ms) ===" << std::endl;
+    std::cout << std::left << std::setw(26) << "Strategy" << std::right
+              << std::setw(10) << "Total" << std::setw(10) << "Annual"
+              << std::setw(9) << "Sharpe" << std::setw(10) << "Max DD" << std::endl;
+    for (size_t i = 0; i < std::min<size_t>(10, runs); ++i) {
+        const MetricsSink& m = candidates[i].metrics;
+        std::cout << std::left << std::setw(26) << candidates[i].label << std::right
+                  << std::setprecision(2) << std::setw(9) << m.total_return() * 100 << "%"
+                  << std::setw(9) << m.annual_return() * 100 << "%"
+                  << std::setprecision(3) << std::setw(9) << m.sharpe()
+                  << std::setprecision(2) << std::setw(9) << m.max_drawdown() * 100 << "%" << std::endl;
+    }
+    return 0;
+}
+
+int run_chunked(const std::string& data_path, size_t chunk_rows, size_t num_regimes, unsigned int seed,
+                bool float_features) {
+    BuyHold bh_strat;
+    Momentum mom_strat(20);
+    MeanReversion mr_strat(20, 1.5);
+    std::vector<Strategy*> strategies = {&bh_strat, &mom_strat, &mr_strat};
+
+    ChunkedPipeline::Config config;
+    config.path = data_path;
+    config.chunk_rows = chunk_rows;
+    config.num_regimes = num_regimes;
+    config.seed = seed;
+    config.single_precision = float_features;
+
+    std::cout << "\nStreaming " << data_path << " in blocks of " << chunk_rows << " rows" << std::endl;
+
+    auto result = ChunkedPipeline::run(config, strategies);
+    std::cout << "Processed " << result.price_rows << " price observations, "
+              << result.feature_rows << " feature rows" << std::endl;
+
+    std::cout << "Regimes detected with inertia: " << result.inertia << std::endl;
+    print_regime_counts(result.regime_counts, result.feature_rows);
+
+    generate_regime_report(summarize_regimes(result));
+
+    std::cout << "\n=== Overall Strategy Performance ===" << std::endl;
+    for (const auto& sr : result.strategies) {
+        print_metrics(sr.name, sr.total_return, sr.annual_return, sr.sharpe, sr.max_drawdown);
+    }
+
+    std::cout << "\n=== Regime-Conditioned Performance ===" << std::endl;
+    for (const auto& sr : result.strategies) {
+        std::cout << "\n=== " << sr.name << " by Regime ===" << std::endl;
+        for (size_t regime = 0; regime < sr.regime_days.size(); ++regime) {
+            if (sr.regime_days[regime] > 0) {
+                print_regime_line(regime, sr.regime_annual_return[regime], sr.regime_sharpe[regime]);
+            }
+        }
+    }
+
+    std::cout << "\n=== Analysis Complete ===" << std::endl;
+    return 0;
+}
+
+int run_ingest(const std::vector<std::string>& trade_files, const std::string& interval,
+               const std::string& out_path) {
+    if (trade_files.empty()) {
+        throw std::invalid_argument("--ingest needs at least one trade file");
+    }
+
+    std::cout << "\nMerging " << trade_files.size() << " trade file(s) into "
+              << interval << " bars" << std::endl;
+
+    // Each bar is written as soon as it closes, so memory stays bounded by
+    // the number of trade files, not the number of bars
+    const int64_t interval_ms = TickAggregator::parse_interval(interval);
+    auto start = std::chrono::steady_clock::now();
+    BarCsvWriter writer(out_path, interval_ms);
+    size_t trades = 0;
+    try {
+        trades = TickAggregator::merge(trade_files, interval_ms,
+                                       [&](const Bar& bar) { writer.write(bar); });
+        writer.close();
+    } catch (...) {
+        writer.discard();  // no half-written bar file on a bad trade file
+        throw;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Aggregated " << trades << " trades into " << writer.bars()
+              << " bars in " << std::fixed << std::setprecision(3) << seconds << " s ("
+              << std::setprecision(2) << (seconds > 0 ? trades / seconds / 1e6 : 0.0)
+              << " M trades/s)" << std::endl;
+    std::cout << "Wrote " << out_path << std::endl;
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     try {
         std::cout << "=== Market Regime & Strategy Attribution Engine ===" << std::endl;
         
-        std::string data_path = (argc > 1) ? argv[1] : "data/sp500.csv";
-        std::cout << "\nLoading data from: " << data_path << std::endl;
-        
-        auto prices = CSVReader::read_price_series(data_path);
-        std::cout << "Loaded " << prices.size() << " price observations" << std::endl;
+        std::vector<std::string> inputs;
+        size_t chunk_rows = 0;
+        unsigned int seed = 42;
+        std::string ingest_path;
+        std::string interval = "1d";
+        std::string socket_path;
+        bool basket = false;
+        bool sweep = false;
+        bool float_features = false;
+        size_t bench_rows = 0;
+        Bootstrap::Config boot_config;
+        std::string regimes_arg = "3";
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--chunk-rows" && i + 1 < argc) {
+                chunk_rows = std::stoul(argv[++i]);
+            } else if (arg == "--seed" && i + 1 < argc) {
+                seed = static_cast<unsigned int>(std::stoul(argv[++i]));
+            } else if (arg == "--ingest" && i + 1 < argc) {
+                ingest_path = argv[++i];
+            } else if (arg == "--interval" && i + 1 < argc) {
+                interval = argv[++i];
+            } else if (arg == "--regimes" && i + 1 < argc) {
+                regimes_arg = argv[++i];
+            } else if (arg == "--bench-kmeans" && i + 1 < argc) {
+                bench_rows = std::stoul(argv[++i]);
+            } else if (arg == "--bootstrap" && i + 1 < argc) {
+                boot_config.replicates = std::stoul(argv[++i]);
+            } else if (arg == "--block-length" && i + 1 < argc) {
+                boot_config.block_length = std::stoul(argv[++i]);
+            } else if (arg == "--float-features") {
+                float_features = true;
+            } else if (arg == "--sweep") {
+                sweep = true;
+            } else if (arg == "--basket") {
+                basket = true;
+            } else if (arg == "--serve" && i + 1 < argc) {
+                socket_path = argv[++i];
+            } else {
+                inputs.push_back(arg);
+            }
+        }
 
-        std::cout << "\nComputing features..." << std::endl;
-        auto returns = Returns::log_returns(prices);
-        auto vol = Volatility::rolling_vol(returns, 20);
-        auto dd = Drawdown::rolling_drawdown(prices, 20);
+        if (bench_rows > 0) {
+            return run_kmeans_benchmark(bench_rows, seed);
+        }
 
-        size_t min_size = std::min({vol.size(), dd.size()});
-        Matrix X(min_size, 2);
-        
-        for (size_t i = 0; i < min_size; ++i) {
-            X(i, 0) = vol[i];
-            X(i, 1) = dd[i];
+        if (!ingest_path.empty()) {
+            return run_ingest(inputs, interval, ingest_path);
+        }
+
+        if (boot_config.block_length == 0) {
+            throw std::invalid_argument("--block-length must be positive");
+        }
+
+        if (basket && inputs.empty()) {
+            throw std::invalid_argument("--basket needs at least one price file");
+        }
+
+        std::string data_path = inputs.empty() ? "data/sp500.csv" : inputs.front();
+        // With --basket every input is loaded and aligned on common dates;
+        // the first is the traded series, the rest feed correlation features
+        std::vector<std::string> asset_paths = basket ? inputs : std::vector<std::string>{data_path};
+
+        const bool auto_regimes = (regimes_arg == "auto");
+        size_t num_regimes = auto_regimes ? 0 : std::stoul(regimes_arg);
+        if (!auto_regimes && num_regimes == 0) {
+            throw std::invalid_argument("--regimes must be a positive count or auto");
+        }
+        // Selection scores the full in-memory feature matrix
+        if (auto_regimes && (!socket_path.empty() || chunk_rows > 0)) {
+            throw std::invalid_argument("--regimes auto needs the in-memory run; "
+                                        "give an explicit count with --serve or --chunk-rows");
+        }
+
+        if (!socket_path.empty()) {
+            std::cout << "\nLoading data from: " << data_path << std::endl;
+            AnalysisServer server(AnalysisContext::load(asset_paths, num_regimes, seed, float_features),
+                                  socket_path);
+            server.stop_on_signals();
+            server.serve();
+            return 0;
         }
 
-        std::cout << "\nDetecting market regimes..." << std::endl;
-        size_t num_regimes = 3;
-        KMeans km(num_regimes, 100, 1e-4);
-        auto regimes = km.fit_predict(X);
+        if (chunk_rows > 0) {
+            if (basket) {
+                throw std::invalid_argument("--basket needs the in-memory run; drop --chunk-rows");
+            }
+            return run_chunked(data_path, chunk_rows, num_regimes, seed, float_features);
+        }
+
+        std::cout << "\nLoading data from: " << data_path << std::endl;
         
-        std::cout << "Regimes detected with inertia: " << km.get_inertia() << std::endl;
-        print_regime_stats(regimes, num_regimes);
+        std::vector<TimeSeries> assets;
+        for (const auto& path : asset_paths) {
+            assets.push_back(CSVReader::read_price_series(path));
+        }
+        CSVReader::align_on_dates(assets);
+        const TimeSeries& prices = assets.front();
+        std::cout << "Loaded " << prices.size() << " price observations" << std::endl;
 
-        generate_regime_report(prices, regimes, num_regimes, X);
+        if (sweep) {
+            return run_sweep(prices);
+        }
+
+        std::cout << "\nComputing features..." << std::endl;
+        if (assets.size() > 1) {
+            std::cout << "Computing rolling correlation across " << assets.size()
+                      << " assets..." << std::endl;
+        }
+        // Float features are built in single precision directly; no double
+        // copy is kept, and the matrix is released once regimes are assigned
+        RegimeIndex regime_index = float_features
+            ? detect_regimes(RegimeFeatures::build<float>(assets), num_regimes, auto_regimes, seed)
+            : detect_regimes(RegimeFeatures::build<double>(assets), num_regimes, auto_regimes, seed);
 
         std::cout << "\n=== Overall Strategy Performance ===" << std::endl;
         
@@ -214,9 +646,17 @@ int main(int argc, char* argv[]) {
         print_strategy_performance(mr_strat.name(), mr_result);
 
         std::cout << "\n=== Regime-Conditioned Performance ===" << std::endl;
-        print_regime_performance(bh_strat, prices, regimes, num_regimes);
-        print_regime_performance(mom_strat, prices, regimes, num_regimes);
-        print_regime_performance(mr_strat, prices, regimes, num_regimes);
+        print_regime_performance(bh_strat.name(), bh_result, regime_index);
+        print_regime_performance(mom_strat.name(), mom_result, regime_index);
+        print_regime_performance(mr_strat.name(), mr_result, regime_index);
+
+        if (boot_config.replicates > 0) {
+            std::cout << "\n=== Regime Bootstrap (block length " << boot_config.block_length
+                      << ") ===" << std::endl;
+            print_regime_confidence(bh_strat.name(), bh_result.returns, regime_index, boot_config);
+            print_regime_confidence(mom_strat.name(), mom_result.returns, regime_index, boot_config);
+            print_regime_confidence(mr_strat.name(), mr_result.returns, regime_index, boot_config);
+        }
 
         std::cout << "\n=== Analysis Complete ===" << std::endl;
 
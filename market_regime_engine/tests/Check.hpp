@@ -0,0 +1,26 @@
+#pragma once
+#include <iostream>
+
+// Minimal self-check support: CHECK reports a failure and keeps going, and
+// main returns check_result() so CTest sees a non-zero exit code
+inline int& check_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond, what)                                                              \
+    do {                                                                               \
+        if (!(cond)) {                                                                 \
+            ++check_failures();                                                        \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " << what << std::endl;    \
+        }                                                                              \
+    } while (0)
+
+inline int check_result(const char* name) {
+    if (check_failures() == 0) {
+        std::cout << name << ": ok" << std::endl;
+        return 0;
+    }
+    std::cerr << name << ": " << check_failures() << " check(s) failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,198 @@
+// Drives the daemon protocol in-process through AnalysisServer::handle, and
+// checks the socket path handling of serve()
+#include "server/AnalysisServer.hpp"
+#include "features/RegimeFeatures.hpp"
+#include "data/CSVReader.hpp"
+#include "models/KMeans.hpp"
+#include "strategies/Momentum.hpp"
+#include "strategies/MeanReversion.hpp"
+#include "backtest/Metrics.hpp"
+#include "Check.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// Numeric value of "key": in a one-line JSON reply; NaN if absent
+static double field(const std::string& json, const std::string& key, size_t from = 0) {
+    size_t pos = json.find("\"" + key + "\":", from);
+    if (pos == std::string::npos) return std::nan("");
+    return std::strtod(json.c_str() + pos + key.size() + 3, nullptr);
+}
+
+static bool ok(const std::string& json) {
+    return json.compare(0, 10, "{\"ok\":true") == 0;
+}
+
+static bool close_to(double a, double b) {
+    return std::fabs(a - b) <= 1e-8 * std::max(1.0, std::fabs(b));
+}
+
+#ifndef _WIN32
+static bool file_exists(const std::string& path) {
+    struct stat st;
+    return ::lstat(path.c_str(), &st) == 0;
+}
+
+static std::string ping(const std::string& path) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::copy(path.begin(), path.end(), addr.sun_path);
+    std::string reply;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+        ::send(fd, "PING\n", 5, 0) == 5) {
+        char c;
+        while (::recv(fd, &c, 1, 0) == 1 && c != '\n') reply += c;
+    }
+    ::close(fd);
+    return reply;
+}
+
+static void check_socket_path(const std::string& dir) {
+    const std::string path = dir + "/test_analysis_server.sock";
+    ::unlink(path.c_str());
+
+    AnalysisServer server(std::make_unique<AnalysisContext>(), path, 1);
+    std::thread serving([&]() { server.serve(); });
+    for (int i = 0; i < 500 && ping(path).empty(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(ping(path) == "{\"ok\":true,\"pong\":true}", "served PING");
+
+    // A second server must not take the path from a live one
+    AnalysisServer rival(std::make_unique<AnalysisContext>(), path, 1);
+    bool refused = false;
+    try {
+        rival.serve();
+    } catch (const std::exception&) {
+        refused = true;
+    }
+    CHECK(refused, "second server replaced a live socket");
+    CHECK(ping(path) == "{\"ok\":true,\"pong\":true}", "live server unreachable after rival start");
+
+    server.stop();
+    serving.join();
+    CHECK(!file_exists(path), "socket file left behind after stop()");
+
+    // A stale socket (nobody listening) is replaced
+    int stale = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::copy(path.begin(), path.end(), addr.sun_path);
+    ::bind(stale, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    ::close(stale);
+    AnalysisServer restarted(std::make_unique<AnalysisContext>(), path, 1);
+    std::thread restarting([&]() { restarted.serve(); });
+    for (int i = 0; i < 500 && ping(path).empty(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(ping(path) == "{\"ok\":true,\"pong\":true}", "stale socket not replaced");
+    restarted.stop();
+    restarting.join();
+
+    // A regular file at the path is never removed
+    { std::ofstream(path) << "keep"; }
+    AnalysisServer blocked(std::make_unique<AnalysisContext>(), path, 1);
+    refused = false;
+    try {
+        blocked.serve();
+    } catch (const std::exception&) {
+        refused = true;
+    }
+    CHECK(refused && file_exists(path), "regular file at the socket path was replaced");
+    ::unlink(path.c_str());
+}
+#endif
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: test_analysis_server <prices.csv>" << std::endl;
+        return 2;
+    }
+    const std::string path = argv[1];
+
+    auto loaded = AnalysisContext::load({path}, 3, 7);
+    const AnalysisContext& ctx = *loaded;
+
+    // Same features and fit as the CLI's in-memory run
+    Matrix X = RegimeFeatures::build<double>({CSVReader::read_price_series(path)});
+    KMeans km(3, 100, 1e-4, 7);
+    km.set_verbose(false);
+    CHECK(km.fit_predict(X) == ctx.regimes && km.get_inertia() == ctx.inertia,
+          "daemon regimes differ from an in-memory fit");
+
+    AnalysisServer server(std::move(loaded), "", 1, 2);
+
+    CHECK(server.handle("PING") == "{\"ok\":true,\"pong\":true}", "PING");
+    CHECK(server.handle("ping") == "{\"ok\":true,\"pong\":true}", "commands are case-insensitive");
+
+    std::string info = server.handle("INFO");
+    CHECK(ok(info) && field(info, "feature_rows") == ctx.features.rows &&
+          field(info, "prices") == ctx.prices.size() && field(info, "regimes") == 3,
+          "INFO: " << info);
+
+    const size_t row = ctx.features.rows / 2;
+    std::string regime = server.handle("REGIME " + ctx.feature_dates[row]);
+    CHECK(ok(regime) && field(regime, "regime") == ctx.regimes[row] &&
+          close_to(field(regime, "volatility"), ctx.features(row, 0)),
+          "REGIME: " << regime);
+    CHECK(!ok(server.handle("REGIME 1900-01-01")), "REGIME accepted an unknown date");
+
+    Momentum momentum(20);
+    Backtester::BacktestResult full = Backtester::run(ctx.prices, momentum);
+    std::string backtest = server.handle("BACKTEST momentum 20");
+    CHECK(ok(backtest) &&
+          close_to(field(backtest, "total_return"), Metrics::total_return(full.equity_curve)) &&
+          close_to(field(backtest, "sharpe"), Metrics::sharpe(full.returns)) &&
+          close_to(field(backtest, "max_drawdown"), Metrics::max_drawdown(full.equity_curve)),
+          "BACKTEST: " << backtest);
+
+    MeanReversion meanrev(20, 1.5);
+    full = Backtester::run(ctx.prices, meanrev);
+    std::vector<ReturnAccumulator> expected(3);
+    ctx.regime_index->for_each_span(full.returns.values, [&](int g, const double* p, size_t n) {
+        for (size_t i = 0; i < n; ++i) expected[g].add(p[i]);
+    });
+    std::string metrics = server.handle("REGIME_METRICS meanrev 20 1.5");
+    CHECK(ok(metrics), "REGIME_METRICS: " << metrics);
+    size_t from = 0;
+    for (int g = 0; g < 3; ++g) {
+        from = metrics.find("{\"regime\":" + std::to_string(g), from);
+        CHECK(from != std::string::npos && field(metrics, "days", from) == expected[g].count() &&
+                  close_to(field(metrics, "sharpe", from), expected[g].sharpe()),
+              "REGIME_METRICS regime " << g << ": " << metrics);
+        if (from == std::string::npos) break;
+    }
+
+    // Capacity 2: evicted specs are recomputed to the same answer
+    std::string first = server.handle("BACKTEST momentum 20");
+    server.handle("BACKTEST momentum 30");
+    server.handle("BACKTEST buyhold");
+    server.handle("BACKTEST meanrev 30 2");
+    CHECK(server.handle("BACKTEST momentum 20") == first, "answer changed after cache eviction");
+    CHECK(server.handle("BACKTEST meanrev 20 1.5") != server.handle("BACKTEST meanrev 20 1.25"),
+          "meanrev thresholds share a cache entry");
+
+    CHECK(!ok(server.handle("BACKTEST meanrev 1")), "meanrev window 1 accepted");
+    CHECK(!ok(server.handle("BACKTEST momentum 0")), "momentum lookback 0 accepted");
+    CHECK(!ok(server.handle("BACKTEST")), "missing strategy accepted");
+    CHECK(!ok(server.handle("FROB")), "unknown command accepted");
+    CHECK(!ok(server.handle("   ")), "empty request accepted");
+
+#ifndef _WIN32
+    const char* tmp = std::getenv("TMPDIR");
+    check_socket_path(tmp ? tmp : "/tmp");
+#endif
+    return check_result("analysis_server");
+}
@@ -0,0 +1,86 @@
+// Bootstrap intervals must not depend on the thread count or batch size, and
+// blocks must stay inside one regime episode
+#include "data/CSVReader.hpp"
+#include "features/RegimeFeatures.hpp"
+#include "models/KMeans.hpp"
+#include "strategies/Momentum.hpp"
+#include "backtest/Backtester.hpp"
+#include "backtest/Bootstrap.hpp"
+#include "core/CounterRng.hpp"
+#include "Check.hpp"
+#include <cmath>
+#include <vector>
+
+static bool same(const Bootstrap::Interval& a, const Bootstrap::Interval& b) {
+    return a.estimate == b.estimate && a.lower == b.lower && a.upper == b.upper;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: test_bootstrap <prices.csv>" << std::endl;
+        return 2;
+    }
+    TimeSeries prices = CSVReader::read_price_series(argv[1]);
+    Matrix X = RegimeFeatures::build<double>({prices});
+    KMeans km(3, 100, 1e-4, 7);
+    km.set_verbose(false);
+    RegimeIndex regimes(km.fit_predict(X), 3);
+
+    Momentum momentum(20);
+    Backtester::BacktestResult result = Backtester::run(prices, momentum);
+
+    Bootstrap::Config base;
+    base.replicates = 2000;
+    base.num_threads = 1;
+    base.batch_size = 256;
+    std::vector<Bootstrap::RegimeInterval> reference = Bootstrap::regime_intervals(result.returns, regimes, base);
+    CHECK(reference.size() == 3, "expected 3 regimes, got " << reference.size());
+
+    for (const auto& r : reference) {
+        if (r.observations < 100) continue;
+        CHECK(r.sharpe.lower <= r.sharpe.estimate && r.sharpe.estimate <= r.sharpe.upper,
+              "regime " << r.regime << " sharpe estimate outside its interval");
+    }
+
+    const size_t variants[][2] = {{4, 256}, {4, 7}, {3, 1000}, {2, 1}};
+    for (const auto& v : variants) {
+        Bootstrap::Config config = base;
+        config.num_threads = v[0];
+        config.batch_size = v[1];
+        std::vector<Bootstrap::RegimeInterval> got = Bootstrap::regime_intervals(result.returns, regimes, config);
+        CHECK(got.size() == reference.size(), "regime count differs (threads=" << v[0] << ")");
+        for (size_t i = 0; i < got.size() && i < reference.size(); ++i) {
+            CHECK(got[i].observations == reference[i].observations &&
+                  same(got[i].sharpe, reference[i].sharpe) &&
+                  same(got[i].annual_return, reference[i].annual_return),
+                  "regime " << i << " interval differs (threads=" << v[0] << ", batch=" << v[1] << ")");
+        }
+    }
+    // Regime 0 episodes are exactly one block long and sum to zero, so every
+    // replicate mean is zero unless a block crosses into a neighbouring
+    // episode. Regime 1 fills the gaps with unrelated returns.
+    CounterRng rng(3, 0);
+    std::vector<int> labels;
+    TimeSeries synthetic;
+    for (int episode = 0; episode < 200; ++episode) {
+        double v = rng.uniform() - 0.5, w = rng.uniform() - 0.5;
+        for (double x : {v, -v, w, -w}) {
+            labels.push_back(0);
+            synthetic.values.push_back(x);
+        }
+        for (size_t t = 0, n = 1 + rng.uniform_index(5); t < n; ++t) {
+            labels.push_back(1);
+            synthetic.values.push_back(rng.uniform() - 0.5);
+        }
+    }
+    Bootstrap::Config blocks;
+    blocks.replicates = 2000;
+    blocks.block_length = 4;
+    auto contained = Bootstrap::regime_intervals(synthetic, RegimeIndex(labels, 2), blocks);
+    const Bootstrap::Interval& zero = contained[0].annual_return;
+    CHECK(std::fabs(zero.lower) < 1e-12 && std::fabs(zero.upper) < 1e-12,
+          "blocks crossed episode boundaries: annual return interval ["
+              << zero.lower << ", " << zero.upper << "]");
+
+    return check_result("bootstrap");
+}
@@ -0,0 +1,107 @@
+// ChunkedPipeline must reproduce the in-memory pipeline (regimes, report
+// statistics and strategy metrics) bit for bit at any chunk size, in double
+// and in float feature precision
+#include "data/CSVReader.hpp"
+#include "features/RegimeFeatures.hpp"
+#include "models/KMeans.hpp"
+#include "models/RegimeIndex.hpp"
+#include "strategies/BuyHold.hpp"
+#include "strategies/Momentum.hpp"
+#include "strategies/MeanReversion.hpp"
+#include "backtest/Backtester.hpp"
+#include "backtest/Metrics.hpp"
+#include "pipeline/ChunkedPipeline.hpp"
+#include "Check.hpp"
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: test_chunked_pipeline <prices.csv>" << std::endl;
+        return 2;
+    }
+    const std::string path = argv[1];
+    const int k = 3;
+    const unsigned seed = 7;
+
+    TimeSeries prices = CSVReader::read_price_series(path);
+    Matrix X = RegimeFeatures::build<double>({prices});
+
+    BuyHold buy_hold;
+    Momentum momentum(20);
+    MeanReversion mean_reversion(9, 1.0);
+    std::vector<Strategy*> strategies = {&buy_hold, &momentum, &mean_reversion};
+    std::vector<Backtester::BacktestResult> full;
+    for (Strategy* s : strategies) full.push_back(Backtester::run(prices, *s));
+
+    for (bool single_precision : {false, true}) {
+        KMeans km(k, 100, 1e-4, seed);
+        km.set_verbose(false);
+        MatrixF Xf(X);
+        std::vector<int> regimes = single_precision ? km.fit_predict(Xf) : km.fit_predict(X);
+
+        // Report statistics as the in-memory run computes them, summing the
+        // stored features in time order
+        RegimeIndex index(regimes, k);
+        std::vector<double> avg_vol(k, 0.0), avg_dd(k, 0.0);
+        for (size_t i = 0; i < regimes.size(); ++i) {
+            avg_vol[regimes[i]] += single_precision ? Xf(i, 0) : X(i, 0);
+            avg_dd[regimes[i]] += single_precision ? Xf(i, 1) : X(i, 1);
+        }
+        for (int g = 0; g < k; ++g) {
+            avg_vol[g] /= index.duration(g);
+            avg_dd[g] /= index.duration(g);
+        }
+
+        for (size_t chunk_rows : {1, 3, 19, 20, 21, 500, 100000}) {
+            ChunkedPipeline::Config config;
+            config.path = path;
+            config.chunk_rows = chunk_rows;
+            config.num_regimes = k;
+            config.seed = seed;
+            config.single_precision = single_precision;
+            ChunkedPipeline::Result res = ChunkedPipeline::run(config, strategies);
+
+            const char* precision = single_precision ? "float" : "double";
+            CHECK(res.inertia == km.get_inertia(),
+                  "inertia differs (" << precision << ", chunk_rows=" << chunk_rows << ")");
+            CHECK(res.feature_rows == X.rows && res.price_rows == prices.size(),
+                  "row counts differ (" << precision << ", chunk_rows=" << chunk_rows << ")");
+
+            for (int g = 0; g < k; ++g) {
+                bool same_transitions = true;
+                for (int h = 0; h < k; ++h) {
+                    same_transitions = same_transitions && res.transitions[g][h] == index.transitions(g, h);
+                }
+                CHECK(res.regime_counts[g] == index.duration(g) &&
+                      res.regime_episodes[g] == index.spans_of(g).size() &&
+                      res.regime_avg_vol[g] == avg_vol[g] && res.regime_avg_dd[g] == avg_dd[g] &&
+                      same_transitions,
+                      "regime " << g << " report statistics differ (" << precision
+                                << ", chunk_rows=" << chunk_rows << ")");
+            }
+
+            for (size_t s = 0; s < strategies.size(); ++s) {
+                const Backtester::BacktestResult& r = full[s];
+                const ChunkedPipeline::StrategyResult& q = res.strategies[s];
+                CHECK(q.total_return == Metrics::total_return(r.equity_curve) &&
+                      q.annual_return == Metrics::annual_return(r.returns) &&
+                      q.sharpe == Metrics::sharpe(r.returns) &&
+                      q.max_drawdown == Metrics::max_drawdown(r.equity_curve),
+                      q.name << " metrics differ (" << precision << ", chunk_rows=" << chunk_rows << ")");
+
+                for (int g = 0; g < k; ++g) {
+                    TimeSeries regime_returns;
+                    for (size_t i = 0; i < regimes.size() && i < r.returns.size(); ++i) {
+                        if (regimes[i] == g) regime_returns.values.push_back(r.returns[i]);
+                    }
+                    CHECK(q.regime_days[g] == regime_returns.size() &&
+                          q.regime_sharpe[g] == Metrics::sharpe(regime_returns) &&
+                          q.regime_annual_return[g] == Metrics::annual_return(regime_returns),
+                          q.name << " regime " << g << " differs (" << precision
+                                 << ", chunk_rows=" << chunk_rows << ")");
+                }
+            }
+        }
+    }
+    return check_result("chunked_pipeline");
+}
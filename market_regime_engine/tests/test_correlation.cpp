@@ -0,0 +1,102 @@
+// RollingCovariance against brute-force window statistics and a dense power
+// iteration on the correlation matrix
+#include "features/Correlation.hpp"
+#include "core/CounterRng.hpp"
+#include "Check.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static Matrix brute_covariance(const std::vector<std::vector<double>>& bars, size_t end, size_t window) {
+    const size_t n = bars.front().size();
+    std::vector<double> mean(n, 0.0);
+    for (size_t t = end - window; t < end; ++t) {
+        for (size_t i = 0; i < n; ++i) mean[i] += bars[t][i];
+    }
+    for (double& m : mean) m /= window;
+
+    Matrix cov(n, n);
+    for (size_t t = end - window; t < end; ++t) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                cov(i, j) += (bars[t][i] - mean[i]) * (bars[t][j] - mean[j]);
+            }
+        }
+    }
+    for (double& c : cov.data) c /= (window - 1);
+    return cov;
+}
+
+static double dense_top_share(const Matrix& corr) {
+    const size_t n = corr.rows;
+    std::vector<double> v(n, 1.0 / std::sqrt(static_cast<double>(n))), y(n);
+    double lambda = 0.0;
+    for (int iter = 0; iter < 10000; ++iter) {
+        double norm = 0.0, next = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            y[i] = 0.0;
+            for (size_t j = 0; j < n; ++j) y[i] += corr(i, j) * v[j];
+            next += v[i] * y[i];
+            norm += y[i] * y[i];
+        }
+        norm = std::sqrt(norm);
+        for (size_t i = 0; i < n; ++i) v[i] = y[i] / norm;
+        if (std::fabs(next - lambda) < 1e-15 * next) break;
+        lambda = next;
+    }
+    return lambda / n;
+}
+
+static void run_case(size_t n, size_t window, size_t refresh, size_t bars_count) {
+    // One common factor plus idiosyncratic noise, so the top eigenvalue is separated
+    CounterRng rng(7, n * 1000 + window);
+    std::vector<std::vector<double>> bars(bars_count, std::vector<double>(n));
+    for (auto& bar : bars) {
+        double factor = rng.uniform() - 0.5;
+        for (size_t i = 0; i < n; ++i) {
+            bar[i] = 0.01 * (factor * (0.5 + 0.05 * i) + (rng.uniform() - 0.5));
+        }
+    }
+
+    RollingCovariance cov(n, window, refresh);
+    double max_cov_err = 0.0, max_avg_err = 0.0, max_eig_err = 0.0;
+    for (size_t t = 0; t < bars_count; ++t) {
+        if (!cov.push(bars[t].data())) continue;
+
+        Matrix brute = brute_covariance(bars, t + 1, window);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                double scale = std::sqrt(brute(i, i) * brute(j, j));
+                max_cov_err = std::max(max_cov_err, std::fabs(cov.covariance(i, j) - brute(i, j)) / scale);
+            }
+        }
+
+        Matrix corr(n, n);
+        double avg = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                corr(i, j) = brute(i, j) / std::sqrt(brute(i, i) * brute(j, j));
+                if (j > i) avg += corr(i, j);
+            }
+        }
+        avg /= n * (n - 1) / 2.0;
+        max_avg_err = std::max(max_avg_err, std::fabs(cov.average_correlation() - avg));
+
+        if (t % 10 == 0) {
+            double share = cov.top_eigenvalue_share(1000, 1e-13);
+            max_eig_err = std::max(max_eig_err, std::fabs(share - dense_top_share(corr)));
+        }
+    }
+
+    CHECK(max_cov_err < 1e-10, "covariance error " << max_cov_err << " (n=" << n << ", refresh=" << refresh << ")");
+    CHECK(max_avg_err < 1e-10, "average correlation error " << max_avg_err << " (n=" << n << ")");
+    CHECK(max_eig_err < 1e-8, "top eigenvalue share error " << max_eig_err << " (n=" << n << ")");
+}
+
+int main() {
+    run_case(2, 20, 0, 300);
+    run_case(12, 30, 0, 400);   // default refresh: one exact rebuild mid-run
+    run_case(12, 30, 7, 400);   // frequent rebuilds
+    run_case(70, 25, 0, 250);   // more than one 64-wide tile
+    return check_result("correlation");
+}
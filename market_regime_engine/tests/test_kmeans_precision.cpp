@@ -0,0 +1,88 @@
+// In-memory K-Means on float features must agree with the double fit, and
+// regime-count selection must reproduce its scored fit in either precision
+#include "data/CSVReader.hpp"
+#include "features/RegimeFeatures.hpp"
+#include "models/KMeans.hpp"
+#include "models/ModelSelection.hpp"
+#include "core/CounterRng.hpp"
+#include "Check.hpp"
+#include <cmath>
+#include <vector>
+
+static size_t same_labels(const std::vector<int>& a, const std::vector<int>& b) {
+    size_t same = 0;
+    for (size_t i = 0; i < a.size() && i < b.size(); ++i) {
+        if (a[i] == b[i]) ++same;
+    }
+    return same;
+}
+
+static void compare_precisions(const char* what, const Matrix& X, const MatrixF& Xf, size_t k) {
+    KMeans km_d(k, 100, 1e-4, 7), km_f(k, 100, 1e-4, 7);
+    km_d.set_verbose(false);
+    km_f.set_verbose(false);
+    std::vector<int> labels_d = km_d.fit_predict(X);
+    std::vector<int> labels_f = km_f.fit_predict(Xf);
+
+    double agreement = static_cast<double>(same_labels(labels_d, labels_f)) / X.rows;
+    double inertia_gap = std::fabs(km_f.get_inertia() - km_d.get_inertia()) / km_d.get_inertia();
+    CHECK(labels_f.size() == X.rows && agreement >= 0.999,
+          what << ": float labels agree on " << agreement * 100 << "% of rows");
+    CHECK(inertia_gap < 1e-4, what << ": float inertia off by " << inertia_gap << " (relative)");
+}
+
+template <typename T>
+static void check_selection_refit(const BasicMatrix<T>& X, const char* what) {
+    ModelSelection::Config config;
+    config.seed = 11;
+    config.max_k = 5;
+    config.silhouette_sample = 300;
+    ModelSelection::Result selection = ModelSelection::select_k(X, config);
+
+    const ModelSelection::Score* chosen = nullptr;
+    for (const auto& score : selection.scores) {
+        if (score.k == selection.best_k) chosen = &score;
+    }
+    CHECK(chosen != nullptr, what << ": selected k has no score");
+    if (!chosen) return;
+
+    KMeans km(selection.best_k, config.max_iters, config.tolerance, selection.best_seed);
+    km.set_verbose(false);
+    km.fit_predict(X);
+    CHECK(km.get_inertia() == chosen->inertia, what << ": refit with the selected seed has inertia "
+                                                     << km.get_inertia() << ", scored " << chosen->inertia);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: test_kmeans_precision <prices.csv>" << std::endl;
+        return 2;
+    }
+    std::vector<TimeSeries> assets = {CSVReader::read_price_series(argv[1])};
+
+    // Building in float is the same as rounding the double features
+    Matrix X = RegimeFeatures::build<double>(assets);
+    MatrixF Xf = RegimeFeatures::build<float>(assets);
+    CHECK(Xf.rows == X.rows && Xf.cols == X.cols && Xf.data == MatrixF(X).data,
+          "float features differ from rounded double features");
+
+    compare_precisions("S&P 500 features", X, Xf, 3);
+
+    // Well-separated synthetic clusters
+    CounterRng rng(5, 0);
+    const size_t rows = 20000, cols = 8, k = 6;
+    Matrix centers(k, cols);
+    for (double& v : centers.data) v = 8.0 * rng.uniform() - 4.0;
+    Matrix G(rows, cols);
+    for (size_t i = 0; i < rows; ++i) {
+        size_t c = rng.uniform_index(static_cast<uint32_t>(k));
+        for (size_t j = 0; j < cols; ++j) {
+            G(i, j) = centers(c, j) + 0.3 * (rng.uniform() + rng.uniform() + rng.uniform() - 1.5);
+        }
+    }
+    compare_precisions("synthetic clusters", G, MatrixF(G), k);
+
+    check_selection_refit(X, "double selection");
+    check_selection_refit(Xf, "float selection");
+    return check_result("kmeans_precision");
+}
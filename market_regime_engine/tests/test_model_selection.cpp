@@ -0,0 +1,120 @@
+// Adjusted Rand index and sampled silhouette against brute-force pair
+// counting and the textbook silhouette definition
+#include "models/ModelSelection.hpp"
+#include "core/CounterRng.hpp"
+#include "Check.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// Hubert-Arabie ARI from the four pair counts
+static double brute_ari(const std::vector<int>& a, const std::vector<int>& b) {
+    double same_same = 0, same_diff = 0, diff_same = 0, diff_diff = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t j = i + 1; j < a.size(); ++j) {
+            bool in_a = a[i] == a[j], in_b = b[i] == b[j];
+            if (in_a && in_b) ++same_same;
+            else if (in_a) ++same_diff;
+            else if (in_b) ++diff_same;
+            else ++diff_diff;
+        }
+    }
+    double denom = (same_same + same_diff) * (same_diff + diff_diff) +
+                   (same_same + diff_same) * (diff_same + diff_diff);
+    return denom == 0.0 ? 1.0 : 2.0 * (same_same * diff_diff - same_diff * diff_same) / denom;
+}
+
+static double brute_silhouette(const std::vector<std::vector<double>>& d, const std::vector<int>& labels,
+                               size_t k) {
+    const size_t m = labels.size();
+    double total = 0.0;
+    for (size_t i = 0; i < m; ++i) {
+        std::vector<double> sum(k, 0.0);
+        std::vector<size_t> size(k, 0);
+        for (size_t j = 0; j < m; ++j) {
+            if (j == i) continue;
+            sum[labels[j]] += d[i][j];
+            size[labels[j]]++;
+        }
+        if (size[labels[i]] == 0) continue;  // singleton
+
+        double a = sum[labels[i]] / size[labels[i]];
+        double b = std::numeric_limits<double>::infinity();
+        for (size_t c = 0; c < k; ++c) {
+            if (static_cast<int>(c) != labels[i] && size[c] > 0) b = std::min(b, sum[c] / size[c]);
+        }
+        if (std::isinf(b)) continue;
+        if (std::max(a, b) > 0.0) total += (b - a) / std::max(a, b);
+    }
+    return total / m;
+}
+
+static std::vector<int> random_labels(CounterRng& rng, size_t n, size_t k) {
+    std::vector<int> labels(n);
+    for (int& l : labels) l = static_cast<int>(rng.uniform_index(static_cast<uint32_t>(k)));
+    return labels;
+}
+
+static void check_ari() {
+    CounterRng rng(32, 0);
+    for (size_t k : {2, 3, 7}) {
+        for (size_t n : {2, 5, 60, 400}) {
+            std::vector<int> a = random_labels(rng, n, k);
+            // b agrees with a on roughly half the points
+            std::vector<int> b = a;
+            for (int& l : b) {
+                if (rng.uniform() < 0.5) l = static_cast<int>(rng.uniform_index(static_cast<uint32_t>(k)));
+            }
+            double got = ModelSelection::adjusted_rand_index(a, b, k);
+            double want = brute_ari(a, b);
+            CHECK(std::fabs(got - want) < 1e-12, "ARI k=" << k << " n=" << n << ": " << got << " vs " << want);
+        }
+    }
+
+    // Renaming clusters does not change a labelling
+    std::vector<int> a = random_labels(rng, 300, 4), renamed(a);
+    for (int& l : renamed) l = (l + 1) % 4;
+    CHECK(ModelSelection::adjusted_rand_index(a, renamed, 4) == 1.0, "ARI of a relabelled partition");
+    CHECK(ModelSelection::adjusted_rand_index(a, a, 4) == 1.0, "ARI of identical partitions");
+}
+
+static void check_silhouette() {
+    CounterRng rng(33, 0);
+    for (size_t k : {2, 3, 5}) {
+        for (size_t m : {3, 10, 150}) {
+            // Points around k centres on a line, plus one forced singleton
+            std::vector<int> labels = random_labels(rng, m, k);
+            labels[0] = static_cast<int>(k - 1);
+            for (size_t i = 1; i < m; ++i) {
+                if (labels[i] == static_cast<int>(k - 1)) labels[i] = 0;
+            }
+            std::vector<double> x(m);
+            for (size_t i = 0; i < m; ++i) x[i] = 3.0 * labels[i] + rng.uniform();
+
+            std::vector<std::vector<double>> d(m, std::vector<double>(m, 0.0));
+            std::vector<double> condensed;
+            for (size_t i = 0; i < m; ++i) {
+                for (size_t j = i + 1; j < m; ++j) {
+                    d[i][j] = d[j][i] = std::fabs(x[i] - x[j]);
+                    condensed.push_back(d[i][j]);
+                }
+            }
+
+            double got = ModelSelection::sampled_silhouette(condensed, labels, k);
+            double want = brute_silhouette(d, labels, k);
+            CHECK(std::fabs(got - want) < 1e-12,
+                  "silhouette k=" << k << " m=" << m << ": " << got << " vs " << want);
+        }
+    }
+
+    // A single cluster has no silhouette
+    std::vector<double> condensed = {1.0, 2.0, 1.0};
+    CHECK(ModelSelection::sampled_silhouette(condensed, {0, 0, 0}, 2) == 0.0, "silhouette of one cluster");
+}
+
+int main() {
+    check_ari();
+    check_silhouette();
+    return check_result("model_selection");
+}
@@ -0,0 +1,118 @@
+// RegimeIndex spans, durations, transitions and slicing against a direct
+// scan of the label sequence
+#include "models/RegimeIndex.hpp"
+#include "core/CounterRng.hpp"
+#include "Check.hpp"
+#include <vector>
+
+static void check_against_labels(const std::vector<int>& labels, size_t k, const char* what) {
+    RegimeIndex index(labels, k);
+    const size_t n = labels.size();
+    CHECK(index.size() == n && index.num_regimes() == k, what << ": size");
+
+    // Spans tile the sequence with maximal constant runs
+    size_t covered = 0;
+    bool spans_ok = true;
+    for (size_t s = 0; s < index.spans().size(); ++s) {
+        const RegimeIndex::Span& span = index.spans()[s];
+        spans_ok = spans_ok && span.start == covered && span.length > 0;
+        for (size_t i = span.start; spans_ok && i < span.start + span.length; ++i) {
+            spans_ok = labels[i] == span.regime;
+        }
+        if (s > 0) spans_ok = spans_ok && index.spans()[s - 1].regime != span.regime;
+        covered += span.length;
+    }
+    CHECK(spans_ok && covered == n, what << ": spans do not tile the labels");
+
+    std::vector<size_t> durations(k, 0), episodes(k, 0);
+    std::vector<size_t> transitions(k * k, 0);
+    for (size_t i = 0; i < n; ++i) {
+        durations[labels[i]]++;
+        if (i == 0 || labels[i] != labels[i - 1]) episodes[labels[i]]++;
+        if (i > 0) transitions[labels[i - 1] * k + labels[i]]++;
+    }
+
+    for (size_t r = 0; r < k; ++r) {
+        const int g = static_cast<int>(r);
+        CHECK(index.duration(g) == durations[r], what << ": duration of regime " << r);
+        CHECK(index.spans_of(g).size() == episodes[r], what << ": episodes of regime " << r);
+        bool in_order = true;
+        for (size_t s = 0; s < index.spans_of(g).size(); ++s) {
+            size_t span = index.spans_of(g)[s];
+            in_order = in_order && index.spans()[span].regime == g &&
+                       (s == 0 || span > index.spans_of(g)[s - 1]);
+        }
+        CHECK(in_order, what << ": spans_of(" << r << ") out of order");
+        for (size_t c = 0; c < k; ++c) {
+            CHECK(index.transitions(g, static_cast<int>(c)) == transitions[r * k + c],
+                  what << ": transitions " << r << " -> " << c);
+        }
+    }
+
+    bool labels_ok = true;
+    for (size_t i = 0; i < n; ++i) {
+        labels_ok = labels_ok && index.label_at(i) == labels[i];
+    }
+    CHECK(labels_ok, what << ": label_at");
+
+    // An aligned series a little shorter than the labels: slicing clips it
+    std::vector<double> values(n > 3 ? n - 3 : 0);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<double>(i);
+
+    std::vector<double> by_regime(k, 0.0), by_span(k, 0.0), expected(k, 0.0);
+    for (size_t i = 0; i < values.size(); ++i) expected[labels[i]] += values[i];
+    for (size_t r = 0; r < k; ++r) {
+        index.for_each(static_cast<int>(r), values, [&](double v) { by_regime[r] += v; });
+    }
+    size_t visited = 0;
+    index.for_each_span(values, [&](int g, const double* p, size_t len) {
+        CHECK(p == values.data() + visited, what << ": for_each_span out of time order");
+        for (size_t i = 0; i < len; ++i) by_span[g] += p[i];
+        visited += len;
+    });
+    CHECK(by_regime == expected && by_span == expected && visited == values.size(),
+          what << ": regime slicing of an aligned series");
+}
+
+int main() {
+    check_against_labels({}, 3, "empty");
+    check_against_labels({2}, 3, "single label");
+    check_against_labels({1, 1, 1, 1, 1}, 2, "one span");
+    check_against_labels({0, 1, 0, 1, 0, 1}, 2, "alternating");
+    check_against_labels({0, 0, 2, 2, 2, 0, 0}, 3, "regime never visited");
+
+    // Persistent random regimes, as K-Means labels tend to be
+    CounterRng rng(29, 0);
+    std::vector<int> labels;
+    int label = 0;
+    for (size_t i = 0; i < 5000; ++i) {
+        if (rng.uniform() < 0.05) label = static_cast<int>(rng.uniform_index(4));
+        labels.push_back(label);
+    }
+    check_against_labels(labels, 4, "random");
+
+    // Incremental append matches construction from the whole sequence
+    RegimeIndex appended(4);
+    for (int l : labels) appended.append(l);
+    RegimeIndex built(labels, 4);
+    CHECK(appended.spans().size() == built.spans().size() &&
+              appended.transitions(1, 2) == built.transitions(1, 2),
+          "append differs from construction");
+
+    bool threw = false;
+    try {
+        appended.append(4);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    CHECK(threw && appended.size() == labels.size(), "out-of-range label accepted");
+
+    threw = false;
+    try {
+        appended.label_at(labels.size());
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    CHECK(threw, "label_at past the end accepted");
+    return check_result("regime_index");
+}
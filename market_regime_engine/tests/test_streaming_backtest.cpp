@@ -0,0 +1,72 @@
+// Streaming backtests (on_price and BacktestSink) must match the full-series
+// Backtester and Metrics bit for bit
+#include "data/CSVReader.hpp"
+#include "strategies/BuyHold.hpp"
+#include "strategies/Momentum.hpp"
+#include "strategies/MeanReversion.hpp"
+#include "backtest/Backtester.hpp"
+#include "backtest/BacktestSink.hpp"
+#include "backtest/Metrics.hpp"
+#include "Check.hpp"
+#include <memory>
+#include <sstream>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: test_streaming_backtest <prices.csv>" << std::endl;
+        return 2;
+    }
+    TimeSeries prices = CSVReader::read_price_series(argv[1]);
+
+    // Synthetic labels shorter than the series, so the tail falls outside the index
+    std::vector<int> labels(prices.size() - 50);
+    for (size_t i = 0; i < labels.size(); ++i) labels[i] = static_cast<int>((i / 37) % 3);
+    RegimeIndex index(labels, 3);
+
+    std::vector<std::unique_ptr<Strategy>> strategies;
+    strategies.emplace_back(new BuyHold());
+    strategies.emplace_back(new Momentum(0));
+    strategies.emplace_back(new MeanReversion(0));
+    strategies.emplace_back(new MeanReversion(1));
+    for (int w = 1; w <= 29; w += 7) strategies.emplace_back(new Momentum(w));
+    for (int v = 6; v < 12; ++v) strategies.emplace_back(new MeanReversion(v * 3 + 4, 0.5 + v * 0.1));
+
+    for (auto& strategy : strategies) {
+        Backtester::BacktestResult full = Backtester::run(prices, *strategy);
+        const std::string name = strategy->name();
+
+        strategy->reset();
+        for (size_t i = 0; i < prices.size(); ++i) {
+            if (strategy->on_price(prices[i]) != full.signals[i]) {
+                CHECK(false, name << " on_price differs from generate_signals at " << i);
+                break;
+            }
+        }
+
+        MetricsSink metrics;
+        RegimeMetricsSink regime_metrics(index);
+        std::ostringstream equity_out;
+        SampledEquitySink equity(equity_out, 100);
+        MultiSink all({&metrics, &regime_metrics, &equity});
+        Backtester::run(prices, *strategy, all);
+
+        CHECK(metrics.total_return() == Metrics::total_return(full.equity_curve) &&
+              metrics.annual_return() == Metrics::annual_return(full.returns) &&
+              metrics.sharpe() == Metrics::sharpe(full.returns) &&
+              metrics.max_drawdown() == Metrics::max_drawdown(full.equity_curve),
+              name << " MetricsSink differs from Metrics");
+
+        std::vector<ReturnAccumulator> expected(3);
+        index.for_each_span(full.returns.values, [&](int g, const double* p, size_t n) {
+            for (size_t i = 0; i < n; ++i) expected[g].add(p[i]);
+        });
+        for (int g = 0; g < 3; ++g) {
+            CHECK(regime_metrics.by_regime()[g].count() == expected[g].count() &&
+                  regime_metrics.by_regime()[g].sharpe() == expected[g].sharpe(),
+                  name << " RegimeMetricsSink regime " << g << " differs");
+        }
+        CHECK(!equity_out.str().empty(), name << " SampledEquitySink wrote nothing");
+    }
+    return check_result("streaming_backtest");
+}
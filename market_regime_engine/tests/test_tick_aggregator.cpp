@@ -0,0 +1,173 @@
+// Trade parsing, k-way merge order and bar boundaries of TickAggregator
+#include "data/TickAggregator.hpp"
+#include "Check.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const int64_t MARCH_1_2024 = 1709251200000LL;  // 2024-03-01T00:00:00Z
+static const int64_t MINUTE = 60000LL;
+
+static std::string temp_dir() {
+    const char* tmp = std::getenv("TMPDIR");
+    return tmp ? tmp : "/tmp";
+}
+
+static std::string write_file(const std::string& name, const std::string& content) {
+    std::string path = temp_dir() + "/test_tick_aggregator_" + name;
+    std::ofstream(path, std::ios::binary) << content;
+    return path;
+}
+
+static std::vector<Trade> read_all(const std::string& path) {
+    TradeReader reader(path);
+    std::vector<Trade> trades;
+    Trade t;
+    while (reader.next(t)) trades.push_back(t);
+    return trades;
+}
+
+static std::vector<Bar> merge_all(const std::vector<std::string>& paths, int64_t interval_ms) {
+    std::vector<Bar> bars;
+    TickAggregator::merge(paths, interval_ms, [&](const Bar& bar) { bars.push_back(bar); });
+    return bars;
+}
+
+static bool throws(void (*f)()) {
+    try {
+        f();
+    } catch (const std::exception&) {
+        return true;
+    }
+    return false;
+}
+
+static void check_timestamps() {
+    // A date-only timestamp followed by another column is midnight; the next
+    // column must not be read as its hour
+    std::string path = write_file("timestamps.csv",
+                                  "timestamp,size,price\n"
+                                  "2024-03-01,5,100\n"
+                                  "2024-03-01T14:30:00.250,1,101\r\n"
+                                  "2024-03-01 14:30:00.250,2,102\n"
+                                  "\n"
+                                  "1709303460000,3,103\n");
+    std::vector<Trade> trades = read_all(path);
+    CHECK(trades.size() == 4, "expected 4 trades, got " << trades.size());
+    if (trades.size() == 4) {
+        CHECK(trades[0].timestamp_ms == MARCH_1_2024,
+              "date-only timestamp parsed as " << trades[0].timestamp_ms);
+        CHECK(trades[0].size == 5 && trades[0].price == 100, "date-only row fields");
+        CHECK(trades[1].timestamp_ms == MARCH_1_2024 + 870 * MINUTE + 250, "ISO 'T' timestamp");
+        CHECK(trades[2].timestamp_ms == trades[1].timestamp_ms, "ISO space-separated timestamp");
+        CHECK(trades[3].timestamp_ms == MARCH_1_2024 + 871 * MINUTE && trades[3].price == 103,
+              "epoch millisecond timestamp");
+    }
+    std::remove(path.c_str());
+
+    CHECK(throws([] {
+              std::string p = write_file("unordered.csv", "ts,price\n2000,1\n1000,1\n");
+              read_all(p);
+          }),
+          "out-of-order trades accepted");
+    CHECK(throws([] {
+              std::string p = write_file("noprice.csv", "ts,size\n1000,1\n");
+              read_all(p);
+          }),
+          "file without a price column accepted");
+}
+
+static void check_merge_order() {
+    // Ties on a timestamp go to the lower source index
+    std::string a = write_file("a.csv", "ts,price,size\n1000,1,1\n3000,3,1\n5000,5,1\n");
+    std::string b = write_file("b.csv", "price,ts\n2,2000\n4,4000\n4.5,5000\n");
+    std::string c = write_file("c.csv", "ts,price\n");
+    std::string d = write_file("d.csv", "ts,price\n0,0.5\n6000,6\n");
+
+    std::vector<Bar> bars = merge_all({a, b, c, d}, 1);  // one bar per distinct timestamp
+    const double expected_open[] = {0.5, 1, 2, 3, 4, 5, 6};
+    CHECK(bars.size() == 7, "expected 7 bars, got " << bars.size());
+    for (size_t i = 0; i < bars.size() && i < 7; ++i) {
+        CHECK(bars[i].start_ms == static_cast<int64_t>(i) * 1000 && bars[i].open == expected_open[i],
+              "bar " << i << " starts at " << bars[i].start_ms << " opening " << bars[i].open);
+    }
+    if (bars.size() == 7) {
+        CHECK(bars[5].trades == 2 && bars[5].open == 5 && bars[5].close == 4.5,
+              "tied trades out of source order");
+    }
+
+    size_t trades = TickAggregator::merge({c}, 1000, [](const Bar&) {});
+    CHECK(trades == 0, "empty file produced trades");
+
+    for (const auto& p : {a, b, c, d}) std::remove(p.c_str());
+}
+
+static void check_bar_boundaries() {
+    // 5-minute bars: a trade exactly on a boundary opens the next bar
+    const int64_t ten = MARCH_1_2024 + 600 * MINUTE;
+    std::ostringstream csv;
+    csv << "ts,price,size\n"
+        << ten - 1 << ",10,1\n"
+        << ten << ",11,2\n"
+        << ten + 2 * MINUTE << ",13,3\n"
+        << ten + 3 * MINUTE << ",9,4\n"
+        << ten + 5 * MINUTE - 1 << ",12,5\n"
+        << ten + 5 * MINUTE << ",14,6\n";
+    std::string path = write_file("bars.csv", csv.str());
+
+    std::vector<Bar> bars = merge_all({path}, TickAggregator::parse_interval("5m"));
+    CHECK(bars.size() == 3, "expected 3 bars, got " << bars.size());
+    if (bars.size() == 3) {
+        CHECK(bars[0].start_ms == ten - 5 * MINUTE && bars[0].trades == 1, "bar before the boundary");
+        const Bar& mid = bars[1];
+        CHECK(mid.start_ms == ten && mid.open == 11 && mid.high == 13 && mid.low == 9 && mid.close == 12 &&
+                  mid.volume == 14 && mid.trades == 4,
+              "bar OHLCV " << mid.open << " " << mid.high << " " << mid.low << " " << mid.close << " "
+                           << mid.volume << " " << mid.trades);
+        CHECK(bars[2].start_ms == ten + 5 * MINUTE && bars[2].open == 14, "bar after the boundary");
+        CHECK(TickAggregator::format_timestamp(mid.start_ms, 5 * MINUTE) == "2024-03-01 10:00",
+              "formatted " << TickAggregator::format_timestamp(mid.start_ms, 5 * MINUTE));
+    }
+
+    // Bars before the epoch floor downwards
+    std::string early = write_file("early.csv", "ts,price\n-60001,1\n-60000,2\n-1,3\n");
+    bars = merge_all({early}, MINUTE);
+    CHECK(bars.size() == 2 && bars[0].start_ms == -2 * MINUTE && bars[0].trades == 1 &&
+              bars[1].start_ms == -MINUTE && bars[1].trades == 2,
+          "pre-epoch bar boundaries");
+    CHECK(TickAggregator::format_timestamp(-MINUTE, MINUTE) == "1969-12-31 23:59",
+          "formatted " << TickAggregator::format_timestamp(-MINUTE, MINUTE));
+    CHECK(TickAggregator::format_timestamp(MARCH_1_2024, TickAggregator::parse_interval("1d")) == "2024-03-01",
+          "daily bar date");
+
+    // Streaming the bars to disk writes the same file as aggregate + write_csv
+    std::string streamed = temp_dir() + "/test_tick_aggregator_streamed.csv";
+    std::string collected = temp_dir() + "/test_tick_aggregator_collected.csv";
+    BarCsvWriter writer(streamed, 5 * MINUTE);
+    TickAggregator::merge({path}, 5 * MINUTE, [&](const Bar& bar) { writer.write(bar); });
+    writer.close();
+    TickAggregator::write_csv(TickAggregator::aggregate({path}, 5 * MINUTE), collected);
+    std::ifstream s1(streamed), s2(collected);
+    std::stringstream c1, c2;
+    c1 << s1.rdbuf();
+    c2 << s2.rdbuf();
+    CHECK(writer.bars() == 3 && c1.str() == c2.str() && !c1.str().empty(),
+          "streamed CSV differs from write_csv:\n" << c1.str() << "---\n" << c2.str());
+
+    for (const auto& p : {path, early, streamed, collected}) std::remove(p.c_str());
+}
+
+int main() {
+    check_timestamps();
+    check_merge_order();
+    check_bar_boundaries();
+
+    CHECK(TickAggregator::parse_interval("30s") == 30000 && TickAggregator::parse_interval("1h") == 3600000,
+          "parse_interval");
+    CHECK(throws([] { TickAggregator::parse_interval("0m"); }), "zero interval accepted");
+    CHECK(throws([] { TickAggregator::parse_interval("5w"); }), "unknown interval unit accepted");
+    return check_result("tick_aggregator");
+}